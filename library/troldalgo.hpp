@@ -34,6 +34,135 @@ SOFTWARE.
 #define TROLDALGO_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ===== Determine if the C library provides memmem (a GNU/BSD extension to <string.h>). This can be overridden by
+// ===== defining TROLDALGO_HAS_MEMMEM to 0 or 1 before including this header.
+#if !defined(TROLDALGO_HAS_MEMMEM)
+#if (defined(__GLIBC__) && defined(_GNU_SOURCE)) || defined(__APPLE__) || defined(__FreeBSD__) || \
+    defined(__NetBSD__) || defined(__OpenBSD__) || defined(__BIONIC__)
+#define TROLDALGO_HAS_MEMMEM 1
+#else
+#define TROLDALGO_HAS_MEMMEM 0
+#endif
+#endif
+
+// ===== Determine if the C library provides memrchr (a GNU extension to <string.h>, also found on the BSDs). This can
+// ===== be overridden by defining TROLDALGO_HAS_MEMRCHR to 0 or 1 before including this header.
+#if !defined(TROLDALGO_HAS_MEMRCHR)
+#if (defined(__GLIBC__) && defined(_GNU_SOURCE)) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+    defined(__OpenBSD__) || defined(__BIONIC__)
+#define TROLDALGO_HAS_MEMRCHR 1
+#else
+#define TROLDALGO_HAS_MEMRCHR 0
+#endif
+#endif
+
+// ===== Determine if SSE2 (and optionally PCLMULQDQ) intrinsics are available for the bitmask kernels. This can be
+// ===== overridden by defining TROLDALGO_HAS_SSE2 to 0 before including this header.
+#if !defined(TROLDALGO_HAS_SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TROLDALGO_HAS_SSE2 1
+#else
+#define TROLDALGO_HAS_SSE2 0
+#endif
+#endif
+
+#if TROLDALGO_HAS_SSE2
+#include <emmintrin.h>
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+#endif
+
+// ===== Determine if SSSE3 intrinsics are available for the character class kernels. This can be overridden by
+// ===== defining TROLDALGO_HAS_SSSE3 to 0 before including this header.
+#if !defined(TROLDALGO_HAS_SSSE3)
+#if TROLDALGO_HAS_SSE2 && (defined(__SSSE3__) || defined(__AVX__))
+#define TROLDALGO_HAS_SSSE3 1
+#else
+#define TROLDALGO_HAS_SSSE3 0
+#endif
+#endif
+
+// ===== Without SSSE3 at compile time, the Teddy kernel of trl::TeddySearcher is compiled for SSSE3 with a target
+// ===== attribute (GCC and Clang on x86), and used if the processor supports SSSE3, as checked at run time. This can
+// ===== be overridden by defining TROLDALGO_HAS_SSSE3_DISPATCH to 0 before including this header.
+#if !defined(TROLDALGO_HAS_SSSE3_DISPATCH)
+#if !TROLDALGO_HAS_SSSE3 && TROLDALGO_HAS_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TROLDALGO_HAS_SSSE3_DISPATCH 1
+#else
+#define TROLDALGO_HAS_SSSE3_DISPATCH 0
+#endif
+#endif
+
+#if TROLDALGO_HAS_SSSE3 || TROLDALGO_HAS_SSSE3_DISPATCH
+#include <tmmintrin.h>
+#endif
+
+#if TROLDALGO_HAS_SSSE3_DISPATCH
+#define TROLDALGO_SSSE3_TARGET __attribute__((target("ssse3")))
+#else
+#define TROLDALGO_SSSE3_TARGET
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// ===== Determine if the compiler can tell whether a function is being evaluated at compile time (the builtin behind
+// ===== std::is_constant_evaluated, which is also available in C++17 mode). If so, the algorithms can be used in constant
+// ===== expressions. This can be overridden by defining TROLDALGO_HAS_CONSTANT_EVALUATED to 0 before including this header.
+#if !defined(TROLDALGO_HAS_CONSTANT_EVALUATED)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define TROLDALGO_HAS_CONSTANT_EVALUATED 1
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#define TROLDALGO_HAS_CONSTANT_EVALUATED 1
+#endif
+#if !defined(TROLDALGO_HAS_CONSTANT_EVALUATED)
+#define TROLDALGO_HAS_CONSTANT_EVALUATED 0
+#endif
+#endif
+
+// ===== Determine if trl::for_each_chunk and trl::TrigramIndex may use multiple threads. This requires linking with the
+// ===== thread library of the platform (e.g. Threads::Threads in CMake), so it must be enabled by defining
+// ===== TROLDALGO_USE_THREADS to 1 before including this header. Otherwise, all the work is done on the calling thread.
+#if !defined(TROLDALGO_USE_THREADS)
+#define TROLDALGO_USE_THREADS 0
+#endif
+#if TROLDALGO_USE_THREADS
+#include <thread>
+#endif
+
+// ===== Functions which return a std::vector (e.g. the find member functions of the delimiter types) can only be
+// ===== constexpr when std::vector is (C++20).
+#if defined(__cpp_lib_constexpr_vector)
+#define TROLDALGO_CONSTEXPR_VECTOR constexpr
+#else
+#define TROLDALGO_CONSTEXPR_VECTOR
+#endif
 
 namespace trl
 {
@@ -54,463 +183,6114 @@ namespace trl
     using IsRandomAccessIterator =
     std::is_same<IteratorCategory<Iter>, std::random_access_iterator_tag>;
 
-    // ===== GENERIC FIND/SEARCH ALGORITHMS
-
     /**
-     * @brief Finds all elements of a given value in a container, in the range [first, last).
-     * @details This algorithm is a wrapper around the std::find algorithm. It simply calls std::find on the provided
-     * container, until all elements have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the letter 'A' in a given string. It will find four items at
-     * position 0, 7, 8 and 15. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all(str.begin(),str.end(), std::back_inserter(results), 'A');
-     *   @endcode
-     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @tparam T The type of the value to find. T will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @param value The value to find.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
+     * @brief A type trait to determine if a container is an associative container that can be searched by value,
+     * i.e. a set-like container such as std::multiset or std::unordered_multiset, with an equal_range member function.
+     * @details Map-like containers are not considered, as their value_type (a key/value pair) differs from the key_type.
      */
-    template<typename InputIt, typename OutputIt, typename T>
-    OutputIt find_all(InputIt first,
-                      InputIt last,
-                      OutputIt d_first,
-                      const T& value) {
-        while (first != last) {
-            first = std::find(first, last, value);
-            if (first != last)
-                *(d_first++) = first++;
-        }
+    template<typename Container, typename = void>
+    struct IsAssociativeContainer : std::false_type {};
 
-        return d_first;
-    }
+    template<typename Container>
+    struct IsAssociativeContainer<Container,
+                                  std::void_t<decltype(std::declval<Container&>().equal_range(
+                                          std::declval<const typename Container::key_type&>()))>>
+            : std::is_same<typename Container::key_type, typename Container::value_type> {};
+
+    namespace detail
+    {
+        /**
+         * @brief Determine if a type is one of the standard character types, i.e. a valid std::basic_string type.
+         */
+        template<typename T>
+        using IsCharType = std::disjunction<std::is_same<T, char>,
+                                            std::is_same<T, wchar_t>,
+                                            std::is_same<T, char16_t>,
+                                            std::is_same<T, char32_t>>;
+
+        /**
+         * @brief Determine if an iterator is contiguous.
+         * @details Raw pointers are always contiguous. With C++20, the std::contiguous_iterator concept is used.
+         * Otherwise, the iterators of std::vector and std::basic_string are recognized. The iterators of std::array
+         * and std::basic_string_view are raw pointers on the major standard library implementations.
+         */
+        template<typename Iter>
+        constexpr bool isContiguousIterator() {
+#if defined(__cpp_lib_concepts)
+            if constexpr (std::contiguous_iterator<Iter>)
+                return true;
+            else
+#endif
+            if constexpr (std::is_pointer<Iter>::value)
+                return true;
+            else {
+                using ValueType = std::remove_cv_t<typename std::iterator_traits<Iter>::value_type>;
+
+                if constexpr (std::is_same<ValueType, bool>::value || !std::is_object<ValueType>::value)
+                    return false;
+                else if constexpr (std::is_same<Iter, typename std::vector<ValueType>::iterator>::value ||
+                                   std::is_same<Iter, typename std::vector<ValueType>::const_iterator>::value)
+                    return true;
+                else if constexpr (IsCharType<ValueType>::value)
+                    return std::is_same<Iter, typename std::basic_string<ValueType>::iterator>::value ||
+                           std::is_same<Iter, typename std::basic_string<ValueType>::const_iterator>::value;
+                else
+                    return false;
+            }
+        }
+    }  // namespace detail
 
     /**
-     * @brief Finds all elements that satisfies a certain criteria (using a predicate) in the range [first, last) of a container.
-     * @details This algorithm is a wrapper around the std::find_if algorithm. It simply calls std::find_if on the provided
-     * container, until all elements have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the letter 'A' in a given string. It will find four items at
-     * position 0, 7, 8 and 15. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all_if(str.begin(),str.end(), std::back_inserter(results), [](char c) {return c == 'A';});
-     *   @endcode
-     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @tparam UnaryPredicate The type of the predicate function. UnaryPredicate will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @param p A unary predicate which returns ​true for the required element.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all_if itself does not throw. However, std::find_if is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
+     * @brief An alias template to determine if an iterator is a contiguous iterator, i.e. if the elements are stored
+     * in contiguous memory, such as the iterators of std::vector, std::string and std::array, or raw pointers.
      */
-    template<typename InputIt, typename OutputIt, typename UnaryPredicate>
-    OutputIt find_all_if(InputIt first,
-                         InputIt last,
-                         OutputIt d_first,
-                         UnaryPredicate p) {
-        while (first != last) {
-            first = std::find_if(first, last, p);
-            if (first != last)
-                *(d_first++) = first++;
-        }
+    template<typename Iter>
+    using IsContiguousIterator =
+    std::bool_constant<detail::isContiguousIterator<Iter>()>;
 
-        return d_first;
-    }
+    // ===== CHARACTER CLASSES
 
     /**
-     * @brief Finds all elements that does NOT satisfy a certain criteria (using a predicate) in the range [first, last) of a container.
-     * @details This algorithm is a wrapper around the std::find_if_not algorithm. It simply calls std::find_if_not on the provided
-     * container, until all elements have been found, or until the last element has been reached.
+     * @brief A set of byte values, which can be used as a predicate, e.g. with trl::find_all_if or trl::ByPredicate.
+     * @details The predefined classes (space, digit, alnum, etc.) follow the "C" locale, i.e. only ASCII characters
+     * are classified. Classes can be combined using the |, & and ~ operators. All operations are constexpr.
+     *
+     * When a CharClass is used with the find_all_if family of algorithms on a contiguous sequence of bytes, it is not
+     * called for each element. Instead, the bytes are classified 16 at a time using table lookups (when SSSE3 is
+     * available). For this reason, the set is stored as a 32 byte table: the low nibble and the high bit of a byte
+     * select an entry, and the remaining three bits select a bit in that entry.
      * #### Example
-     * The following example will find all occurrences of letters not equaling 'A' in a given string. It will find 13 items at
-     * position 1, 2, 3, 4, 5, 6, 9, 10, 11, 12, 13, 14 and 16. Iterators to those elements will be copied to the results vector.
+     * The following example will find the positions of all whitespace characters in a string.
      *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      auto str = std::string("split on\tany whitespace");
      *      std::vector<decltype(str.begin())> results;
-     *      trl::find_all_if_not(str.begin(),str.end(), std::back_inserter(results), [](char c) {return c == 'A';});
+     *      trl::find_all_if(str.begin(), str.end(), std::back_inserter(results), trl::CharClass::space());
      *   @endcode
-     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @tparam UnaryPredicate The type of the predicate function. UnaryPredicate will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @param p A unary predicate which returns ​true for the required element.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all_if_not itself does not throw. However, std::find_if_not is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
      */
-    template<typename InputIt, typename OutputIt, typename UnaryPredicate>
-    OutputIt find_all_if_not(InputIt first,
-                             InputIt last,
-                             OutputIt d_first,
-                             UnaryPredicate p) {
-        while (first != last) {
-            first = std::find_if_not(first, last, p);
-            if (first != last)
-                *(d_first++) = first++;
+    class CharClass
+    {
+    public:
+
+        /**
+         * @brief Default constructor, creating an empty character class.
+         */
+        constexpr CharClass() = default;
+
+        /**
+         * @brief Create a character class from the characters in a null-terminated string.
+         */
+        static constexpr CharClass of(const char* chars) {
+            CharClass result;
+            for (; *chars != '\0'; ++chars)
+                result.insert(static_cast<unsigned char>(*chars));
+            return result;
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Create a character class from the (inclusive) range of byte values [first, last].
+         */
+        static constexpr CharClass range(unsigned char first, unsigned char last) {
+            CharClass result;
+            for (unsigned value = first; value <= last; ++value)
+                result.insert(static_cast<unsigned char>(value));
+            return result;
+        }
 
-    /**
-     * @brief Finds the first elements that does NOT satisfy any of the given search elements, in the range [first, last) of a container.
-     * @details This algorithm is a wrapper around the std::find_if and std::find algorithm.
-     * #### Example
-     * The following example will find the first occurrence of a letter not equaling 'A' or 'B' in a given string. It will find
-     * it as index 2. An Iterator to the element will be returned.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
-     *      auto src = std::string("AB");
-     *      trl::find_first_not_of(str.begin(),str.end(), src.begin(), src.end());
-     *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the range of elements to search for.
-     * @param s_last One element beyond the last element in the range to search for.
-     * @return An iterator pointing to the element found; if none has been found, \c last will be returned.
-     * @throws Undefined std::find_if and std::find does not throw. However, they is not marked noexcept, so they might throw,
-     * but documentation does not reveal any details.
-     */
-    template<typename ForwardIt1, typename ForwardIt2>
-    ForwardIt1 find_first_not_of(ForwardIt1 first,
-                                 ForwardIt1 last,
-                                 ForwardIt2 s_first,
-                                 ForwardIt2 s_last) {
+        /**
+         * @brief The whitespace characters, i.e. ' ', '\t', '\n', '\v', '\f' and '\r' (as std::isspace).
+         */
+        static constexpr CharClass space() { return of(" \t\n\v\f\r"); }
 
-        return std::find_if(first, last, [&](const decltype(*first)& val) {
-            return (std::find(s_first, s_last, val) == s_last);
-        });
-    }
+        /**
+         * @brief The decimal digits '0' to '9' (as std::isdigit).
+         */
+        static constexpr CharClass digit() { return range('0', '9'); }
 
-    // TODO(troldal): Implement trl::find_first_not_of with predicates.
-
-//    /**
-//     * @brief
-//     * @tparam InputIt
-//     * @tparam ForwardIt
-//     * @tparam BinaryPredicate
-//     * @param first
-//     * @param last
-//     * @param s_first
-//     * @param s_last
-//     * @param p
-//     * @return
-//     */
-//    template<typename InputIt, typename ForwardIt, typename BinaryPredicate>
-//    constexpr InputIt find_first_not_of(InputIt first,
-//                                        InputIt last,
-//                                        ForwardIt s_first,
-//                                        ForwardIt s_last,
-//                                        BinaryPredicate p) {
-//        return std::find_if(first, last, [&](const decltype(*first)& val) {
-//            return (std::find_if(s_first, s_last, !p) == s_last);
-//        });
-//    }
+        /**
+         * @brief The upper case letters 'A' to 'Z' (as std::isupper).
+         */
+        static constexpr CharClass upper() { return range('A', 'Z'); }
 
+        /**
+         * @brief The lower case letters 'a' to 'z' (as std::islower).
+         */
+        static constexpr CharClass lower() { return range('a', 'z'); }
 
-    /**
-     * @brief Finds all elements of a given range of value in a container, in the range [first, last).
-     * @details This algorithm is a wrapper around the std::find_first_of algorithm. It simply calls std::find_first_of
-     * on the provided container, until all elements have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the letters {'A', 'B'} in a given string. It will find eight items at
-     * position 0, 1, 6, 7, 8, 9, 14 and 15. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
-     *      auto src = std::string("AB");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
-     *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the search range.
-     * @param s_last The last element in the search range.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
-     */
-    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
-    OutputIt find_all_of(ForwardIt1 first,
-                         ForwardIt1 last,
-                         ForwardIt2 s_first,
-                         ForwardIt2 s_last,
-                         OutputIt d_first) {
-        while (first != last) {
-            first = std::find_first_of(first, last, s_first, s_last);
-            if (first != last) {
-                *(d_first++) = first;
-                first++;
-            }
+        /**
+         * @brief The letters (as std::isalpha).
+         */
+        static constexpr CharClass alpha() { return upper() | lower(); }
+
+        /**
+         * @brief The letters and decimal digits (as std::isalnum).
+         */
+        static constexpr CharClass alnum() { return alpha() | digit(); }
+
+        /**
+         * @brief The punctuation characters, i.e. the printable, non-alphanumeric characters except ' ' (as std::ispunct).
+         */
+        static constexpr CharClass punct() { return range('!', '~') & ~alnum(); }
+
+        /**
+         * @brief Union of two character classes.
+         */
+        constexpr CharClass operator|(const CharClass& other) const {
+            CharClass result;
+            for (int i = 0; i < 32; ++i)
+                result.m_table[i] = static_cast<unsigned char>(m_table[i] | other.m_table[i]);
+            return result;
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Intersection of two character classes.
+         */
+        constexpr CharClass operator&(const CharClass& other) const {
+            CharClass result;
+            for (int i = 0; i < 32; ++i)
+                result.m_table[i] = static_cast<unsigned char>(m_table[i] & other.m_table[i]);
+            return result;
+        }
 
-    /**
-     * @brief Finds all elements of a given range of value in a container, in the range [first, last), using a predicate.
-     * @details This algorithm is a wrapper around the std::find_first_of algorithm. It simply calls std::find_first_of
-     * on the provided container, until all elements have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the letters {'A', 'B'} in a given string. It will find eight items at
-     * position 0, 1, 6, 7, 8, 9, 14 and 15. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
-     *      auto src = std::string("AB");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results), [](const char& a, const char& b) { return a == b; });
-     *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @tparam BinaryPredicate A binary predicate which returns ​true if the elements should be treated as equal.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the search range.
-     * @param s_last The last element in the search range.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @param p A binary predicate which returns ​true if the elements should be treated as equal.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
-     */
-    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt, typename BinaryPredicate>
-    OutputIt find_all_of(ForwardIt1 first,
-                         ForwardIt1 last,
-                         ForwardIt2 s_first,
-                         ForwardIt2 s_last,
-                         OutputIt d_first,
-                         BinaryPredicate p) {
-        while (first != last) {
-            first = std::find_first_of(first, last, s_first, s_last, p);
-            if (first != last) {
-                *(d_first++) = first;
-                first++;
+        /**
+         * @brief Complement of the character class, i.e. all byte values not in the class.
+         */
+        constexpr CharClass operator~() const {
+            CharClass result;
+            for (int i = 0; i < 32; ++i)
+                result.m_table[i] = static_cast<unsigned char>(~m_table[i]);
+            return result;
+        }
+
+        /**
+         * @brief Determine if a byte value is in the character class.
+         */
+        [[nodiscard]] constexpr bool contains(unsigned char value) const {
+            return ((m_table[(value >> 7) * 16 + (value & 15)] >> ((value >> 4) & 7)) & 1) != 0;
+        }
+
+        /**
+         * @brief Determine if an element is in the character class. Values outside the range of unsigned char (for
+         * elements wider than a byte) are never in the class. Single byte elements are interpreted as unsigned char.
+         */
+        template<typename T>
+        [[nodiscard]] constexpr bool operator()(const T& value) const {
+            static_assert(std::is_integral<T>::value, "CharClass can only classify integral (character) values!");
+
+            if constexpr (std::is_same<T, unsigned char>::value)
+                return contains(value);
+            else if constexpr (sizeof(T) == 1)
+                return contains(static_cast<unsigned char>(value));
+            else {
+                if constexpr (std::is_signed<T>::value)
+                    if (value < 0)
+                        return false;
+                return value <= static_cast<T>(255) && contains(static_cast<unsigned char>(value));
             }
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Get the 32 byte lookup table, used by the vectorized kernels.
+         */
+        [[nodiscard]] constexpr const unsigned char* table() const {
+            return m_table;
+        }
 
-    /**
-     * @brief Finds all elements NOT in a given range of values in a container, in the range [first, last).
-     * @details This algorithm is a wrapper around the trl::find_first_not_of algorithm. It simply calls trl::find_first_not_of
-     * on the provided container, until all elements have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences NOT equal to the letters {'A', 'B'} in a given string. It will find
-     * nine items at position 2,3,4,5,10,11,12,13 and 16. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+    private:
+
+        /**
+         * @brief Add a byte value to the character class.
+         */
+        constexpr void insert(unsigned char value) {
+            m_table[(value >> 7) * 16 + (value & 15)] |= static_cast<unsigned char>(1u << ((value >> 4) & 7));
+        }
+
+        unsigned char m_table[32] = {}; /**< The lookup table; see the class description for the layout. */
+    };
+
+    // ===== CONTIGUOUS MEMORY KERNELS
+
+    namespace detail
+    {
+        /**
+         * @brief Determine if the elements of type T can be compared using the block-wise kernels. This is the case
+         * for integral types (except bool), where comparisons are cheap and have no side effects.
+         */
+        template<typename T>
+        using IsBlockComparable = std::conjunction<std::is_integral<T>, std::negation<std::is_same<T, bool>>>;
+
+        /**
+         * @brief Convert a value to the element type T, without emitting a cast if it already has that type.
+         */
+        template<typename T, typename U>
+        constexpr T narrow(const U& value) {
+            if constexpr (std::is_same<T, U>::value)
+                return value;
+            else
+                return static_cast<T>(value);
+        }
+
+        /**
+         * @brief Determine if an element of type T can ever compare equal to value. If not, the value can not be
+         * converted to T without changing it, and a search for the value will never find anything.
+         */
+        template<typename T, typename U>
+        constexpr bool isRepresentable(const U& value) {
+            if constexpr (std::is_same<T, U>::value)
+                return true;
+            else
+                return static_cast<U>(static_cast<T>(value)) == value;
+        }
+
+        /**
+         * @brief Determine if the function is being evaluated at compile time. The contiguous memory kernels (the C
+         * library byte functions and the SIMD intrinsics) can not be evaluated at compile time, so the algorithms fall
+         * back to simple loops in that case. Without compiler support (see TROLDALGO_HAS_CONSTANT_EVALUATED), this is
+         * always false, and the algorithms can not be used in constant expressions.
+         */
+        constexpr bool isConstantEvaluated() noexcept {
+#if TROLDALGO_HAS_CONSTANT_EVALUATED
+            return __builtin_is_constant_evaluated();
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Run a kernel on the range [first, last). If the iterators are contiguous, the kernel is called with
+         * raw pointers to the elements, and the resulting pointer is converted back to an iterator.
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @param kernel A callable taking a begin/end pair of iterators or pointers, and returning the position found.
+         * @return An iterator to the position found by the kernel.
+         */
+        template<typename Iter, typename Kernel>
+        Iter lowerToPointers(Iter first, Iter last, Kernel kernel) {
+            if constexpr (IsContiguousIterator<Iter>::value) {
+                if (first == last)
+                    return last;
+
+                auto* ptr = std::addressof(*first);
+                return first + (kernel(ptr, ptr + (last - first)) - ptr);
+            }
+            else
+                return kernel(first, last);
+        }
+
+        /**
+         * @brief Determine if the elements of type T can be compared using the C library byte functions (memchr,
+         * memcmp, memmem), i.e. if T is a single byte, block-comparable type.
+         */
+        template<typename T>
+        using IsByteComparable = std::conjunction<IsBlockComparable<T>, std::bool_constant<sizeof(T) == 1>>;
+
+        /**
+         * @brief Reinterpret a pointer to byte-sized elements as a pointer to unsigned char.
+         */
+        template<typename T>
+        const unsigned char* asBytes(const T* ptr) {
+            if constexpr (std::is_same<T, unsigned char>::value)
+                return ptr;
+            else
+                return reinterpret_cast<const unsigned char*>(ptr);
+        }
+
+        /**
+         * @brief Find the first byte equal to value in the range [first, last), using memchr.
+         * @details The first few bytes are examined with a simple loop, as the call overhead of memchr dominates when
+         * the matches are close together.
+         */
+        inline const unsigned char* findByte(const unsigned char* first, const unsigned char* last, unsigned char value) {
+            const auto* prefixLast = first + std::min<std::ptrdiff_t>(last - first, 16);
+            for (; first != prefixLast; ++first)
+                if (*first == value)
+                    return first;
+
+            const void* result = std::memchr(first, value, static_cast<std::size_t>(last - first));
+            return result ? static_cast<const unsigned char*>(result) : last;
+        }
+
+        /**
+         * @brief Compare two byte sequences of the given length. Short sequences are compared with a simple loop,
+         * to avoid the call overhead of memcmp.
+         */
+        inline bool equalBytes(const unsigned char* lhs, const unsigned char* rhs, std::size_t length) {
+            if (length > 16)
+                return std::memcmp(lhs, rhs, length) == 0;
+
+            for (std::size_t i = 0; i < length; ++i)
+                if (lhs[i] != rhs[i])
+                    return false;
+            return true;
+        }
+
+        /**
+         * @brief Search for the first occurrence of the byte sequence [s_first, s_last) in the range [first, last).
+         * @details Candidates are located with memchr on the first byte of the sequence, and verified with memcmp. This
+         * outperforms memmem for most inputs, but degrades when the first byte is frequent. If the candidates turn out
+         * to be mostly false positives, the remainder of the range is therefore searched with memmem, when available.
+         */
+        inline const unsigned char* searchBytes(const unsigned char* first,
+                                                const unsigned char* last,
+                                                const unsigned char* s_first,
+                                                const unsigned char* s_last) {
+            const auto length = static_cast<std::size_t>(s_last - s_first);
+            if (length == 0)
+                return first;
+            if (static_cast<std::size_t>(last - first) < length)
+                return last;
+
+            const auto*   candidateLast  = last - length + 1;
+            const auto*   start          = first;
+            std::ptrdiff_t falsePositives = 0;
+            while (first != candidateLast) {
+                first = findByte(first, candidateLast, *s_first);
+                if (first == candidateLast)
+                    break;
+                if (equalBytes(first + 1, s_first + 1, length - 1))
+                    return first;
+                ++first;
+
+#if TROLDALGO_HAS_MEMMEM
+                // ===== Switch to memmem if there has been more than one false positive per 16 bytes examined.
+                if (++falsePositives > 64 && (first - start) < falsePositives * 16) {
+                    const void* result = ::memmem(first, static_cast<std::size_t>(last - first), s_first, length);
+                    return result ? static_cast<const unsigned char*>(result) : last;
+                }
+#else
+                (void)start;
+                (void)falsePositives;
+#endif
+            }
+            return last;
+        }
+
+        /**
+         * @brief Find the first element equal to value, in the range [first, last).
+         * @details For raw pointers to byte-sized elements, memchr is used. For raw pointers to other integral
+         * elements, the range is examined in blocks of one cache line, without any branches inside the block, which
+         * allows the compiler to vectorize the loop.
+         */
+        template<typename Iter, typename T>
+        Iter findKernel(Iter first, Iter last, const T& value) {
+            using ValueType = typename std::iterator_traits<Iter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsBlockComparable<ValueType>::value &&
+                          IsBlockComparable<T>::value) {
+                if (!isRepresentable<ValueType>(value))
+                    return last;
+
+                if constexpr (IsByteComparable<ValueType>::value) {
+                    const auto* bytes = asBytes(first);
+                    const auto  byte  = narrow<unsigned char>(narrow<ValueType>(value));
+                    return first + (findByte(bytes, bytes + (last - first), byte) - bytes);
+                }
+
+                constexpr std::ptrdiff_t BlockSize = 64 / sizeof(ValueType);
+                const auto               elem      = narrow<ValueType>(value);
+                while (last - first >= BlockSize) {
+                    unsigned match = 0;
+                    for (std::ptrdiff_t i = 0; i < BlockSize; ++i)
+                        match |= static_cast<unsigned>(first[i] == elem);
+                    if (match != 0)
+                        break;
+                    first += BlockSize;
+                }
+                return std::find(first, last, elem);
+            }
+            else
+                return std::find(first, last, value);
+        }
+
+        /**
+         * @brief Search for the first occurrence of the sequence [s_first, s_last) in the range [first, last).
+         * @details If both ranges are contiguous byte sequences of the same signedness, searchBytes is used. Otherwise,
+         * for raw pointers to integral elements, candidates are located with findKernel, using the first element of
+         * the sequence.
+         */
+        template<typename Iter, typename SeqIter>
+        Iter searchKernel(Iter first, Iter last, SeqIter s_first, SeqIter s_last) {
+            using ValueType    = typename std::iterator_traits<Iter>::value_type;
+            using SeqValueType = typename std::iterator_traits<SeqIter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsBlockComparable<ValueType>::value &&
+                          IsBlockComparable<SeqValueType>::value) {
+                if (s_first == s_last)
+                    return first;
+
+                if constexpr (IsContiguousIterator<SeqIter>::value && IsByteComparable<ValueType>::value &&
+                              IsByteComparable<SeqValueType>::value &&
+                              std::is_signed<ValueType>::value == std::is_signed<SeqValueType>::value) {
+                    const auto* bytes    = asBytes(first);
+                    const auto* seqBytes = asBytes(std::addressof(*s_first));
+                    const auto* result   = searchBytes(bytes,
+                                                       bytes + (last - first),
+                                                       seqBytes,
+                                                       seqBytes + (s_last - s_first));
+                    return first + (result - bytes);
+                }
+
+                const auto length = std::distance(s_first, s_last);
+                while (last - first >= length) {
+                    first = findKernel(first, last - length + 1, *s_first);
+                    if (first == last - length + 1)
+                        break;
+                    if (std::equal(std::next(s_first), s_last, first + 1))
+                        return first;
+                    ++first;
+                }
+                return last;
+            }
+            else
+                return std::search(first, last, s_first, s_last);
+        }
+
+        /**
+         * @brief Compare two elements, using the predicate if one is given, or operator== otherwise.
+         */
+        template<typename T, typename U, typename... BinaryPredicate>
+        constexpr bool equals(T&& lhs, U&& rhs, BinaryPredicate&... p) {
+            if constexpr (sizeof...(BinaryPredicate) == 0)
+                return lhs == rhs;
+            else
+                return (p(std::forward<T>(lhs), std::forward<U>(rhs)), ...);
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::find. At compile time, a simple loop is used.
+         */
+        template<typename InputIt, typename T>
+        constexpr InputIt find(InputIt first, InputIt last, const T& value) {
+            if (isConstantEvaluated()) {
+                for (; first != last; ++first)
+                    if (*first == value)
+                        return first;
+                return last;
+            }
+
+            return lowerToPointers(first, last, [&](auto f, auto l) { return findKernel(f, l, value); });
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::find_first_of. At compile time, a simple loop is used.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename... BinaryPredicate>
+        constexpr ForwardIt1 find_first_of(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last,
+                                           BinaryPredicate... p) {
+            if (isConstantEvaluated()) {
+                for (; first != last; ++first)
+                    for (auto it = s_first; it != s_last; ++it)
+                        if (equals(*first, *it, p...))
+                            return first;
+                return last;
+            }
+
+            return lowerToPointers(first, last, [&](auto f, auto l) {
+                return std::find_first_of(f, l, s_first, s_last, p...);
+            });
+        }
+
+        /**
+         * @brief Search for the first occurrence of the sequence [s_first, s_last) in the range [first, last), by
+         * comparing the sequence at each position. This is used at compile time.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename... BinaryPredicate>
+        constexpr ForwardIt1 searchLoop(ForwardIt1 first,
+                                        ForwardIt1 last,
+                                        ForwardIt2 s_first,
+                                        ForwardIt2 s_last,
+                                        BinaryPredicate&... p) {
+            for (;; ++first) {
+                auto it = first;
+                for (auto s_it = s_first;; ++it, ++s_it) {
+                    if (s_it == s_last)
+                        return first;
+                    if (it == last)
+                        return last;
+                    if (!equals(*it, *s_it, p...))
+                        break;
+                }
+            }
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::search. At compile time, a simple loop is used.
+         */
+        template<typename ForwardIt1, typename ForwardIt2>
+        constexpr ForwardIt1 search(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last) {
+            if (isConstantEvaluated())
+                return searchLoop(first, last, s_first, s_last);
+
+            return lowerToPointers(first, last, [&](auto f, auto l) { return searchKernel(f, l, s_first, s_last); });
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::search, using a predicate. At compile time, a simple loop is used.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename BinaryPredicate>
+        constexpr ForwardIt1 search(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last,
+                                    BinaryPredicate p) {
+            if (isConstantEvaluated())
+                return searchLoop(first, last, s_first, s_last, p);
+
+            return lowerToPointers(first, last, [&](auto f, auto l) { return std::search(f, l, s_first, s_last, p); });
+        }
+
+        /**
+         * @brief Compute a bitmask of the bytes equal to value, in the 64 bytes starting at ptr. Bit i is set if
+         * ptr[i] equals value. With SSE2, 16 bytes are compared per instruction.
+         */
+        inline std::uint64_t equalMask64(const unsigned char* ptr, unsigned char value) {
+            std::uint64_t mask = 0;
+#if TROLDALGO_HAS_SSE2
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+            for (int i = 0; i < 4; ++i) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 16 * i));
+                const auto    bits  = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+                mask |= static_cast<std::uint64_t>(bits) << (16 * i);
+            }
+#else
+            for (int i = 0; i < 64; ++i)
+                mask |= static_cast<std::uint64_t>(ptr[i] == value) << i;
+#endif
+            return mask;
+        }
+
+        /**
+         * @brief Compute the prefix XOR of a bitmask, i.e. bit i of the result is the XOR of bits 0 to i of the input.
+         * @details Applied to a bitmask of quote characters, this gives a mask of the bytes inside quotes. With
+         * PCLMULQDQ, this is a carry-less multiplication by an all-ones value; otherwise, six shift/XOR steps are used.
+         */
+        inline std::uint64_t prefixXor(std::uint64_t bits) {
+#if TROLDALGO_HAS_SSE2 && defined(__PCLMUL__)
+            const __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(bits)),
+                                                         _mm_set1_epi8(-1),
+                                                         0);
+            return static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+#else
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+#endif
+        }
+
+        /**
+         * @brief Count the number of trailing zero bits of a non-zero value, i.e. the index of the lowest set bit.
+         */
+        inline int countTrailingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return static_cast<int>(index);
+#else
+            int count = 0;
+            for (; (value & 1) == 0; value >>= 1)
+                ++count;
+            return count;
+#endif
+        }
+
+        /**
+         * @brief Get the index of the highest set bit of a non-zero value.
+         */
+        inline int highestSetBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return static_cast<int>(index);
+#else
+            int index = 0;
+            while (value >>= 1)
+                ++index;
+            return index;
+#endif
+        }
+
+        /**
+         * @brief Count the set bits of a value.
+         */
+        inline int popCount(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(value);
+#else
+            value = value - ((value >> 1) & 0x5555555555555555ULL);
+            value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+            value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        /**
+         * @brief Run a block function on the byte range [first, last), in blocks of 64 bytes.
+         * @details The block function is called with a pointer to 64 readable bytes, a pointer to the corresponding
+         * position in the range, and a bitmask of the bytes that are part of the range. The final (partial) block is
+         * copied to a zero-padded buffer. The block function returns false to stop the scan.
+         */
+        template<typename BlockFunction>
+        void forEachBlock64(const unsigned char* first, const unsigned char* last, BlockFunction function) {
+            for (; last - first >= 64; first += 64)
+                if (!function(first, first, ~std::uint64_t(0)))
+                    return;
+
+            if (first != last) {
+                unsigned char buffer[64] = {};
+                std::memcpy(buffer, first, static_cast<std::size_t>(last - first));
+                function(static_cast<const unsigned char*>(buffer),
+                         first,
+                         (std::uint64_t(1) << (last - first)) - 1);
+            }
+        }
+
+#if TROLDALGO_HAS_SSSE3
+        /**
+         * @brief Compute a bitmask of the bytes in the character class, in the 16 bytes starting at ptr. The low
+         * nibble of each byte selects an entry in the table for bytes below or above 0x80 (using pshufb), and the next
+         * three bits select a bit in that entry.
+         */
+        inline unsigned classMask16(const unsigned char* ptr, const CharClass& charClass) {
+            const __m128i lowTable  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(charClass.table()));
+            const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(charClass.table() + 16));
+            const __m128i bitTable  = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            const __m128i nibble    = _mm_set1_epi8(0x0f);
+
+            const __m128i chunk  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            const __m128i low    = _mm_and_si128(chunk, nibble);
+            const __m128i high   = _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble);
+            const __m128i isHigh = _mm_cmplt_epi8(chunk, _mm_setzero_si128());
+            const __m128i rows   = _mm_or_si128(_mm_andnot_si128(isHigh, _mm_shuffle_epi8(lowTable, low)),
+                                                _mm_and_si128(isHigh, _mm_shuffle_epi8(highTable, low)));
+            const __m128i bits   = _mm_shuffle_epi8(bitTable, high);
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(rows, bits), bits)));
+        }
+#endif
+
+        /**
+         * @brief Determine if the processor supports SSSE3, for the kernels which are selected at run time.
+         */
+        inline bool hasSsse3() {
+#if TROLDALGO_HAS_SSSE3
+            return true;
+#elif TROLDALGO_HAS_SSSE3_DISPATCH
+            static const bool supported = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("ssse3") != 0;
+            }();
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+#if TROLDALGO_HAS_SSSE3 || TROLDALGO_HAS_SSSE3_DISPATCH
+        /**
+         * @brief Teddy kernel: compute the candidate buckets of the 16 positions starting at ptr, for a multi-literal
+         * search. For each of the first fingerprint bytes of the literals, the low and high nibbles of the byte each
+         * select a mask of the buckets (using pshufb), and the masks of all nibbles are AND'ed together. The buckets of
+         * each position are stored in buckets, and a bitmask of the positions with any candidate bucket is returned.
+         * The bytes in the range [ptr, ptr + 15 + fingerprint) must be readable.
+         */
+        TROLDALGO_SSSE3_TARGET inline unsigned teddyMask16(const unsigned char* ptr,
+                                                           const unsigned char (&masks)[4][32],
+                                                           int                  fingerprint,
+                                                           unsigned char*       buckets) {
+            const __m128i nibble = _mm_set1_epi8(0x0f);
+            __m128i       result = _mm_set1_epi8(-1);
+            for (int k = 0; k < fingerprint; ++k) {
+                const __m128i lowTable  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks[k]));
+                const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks[k] + 16));
+                const __m128i chunk     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + k));
+                const __m128i low       = _mm_shuffle_epi8(lowTable, _mm_and_si128(chunk, nibble));
+                const __m128i high      = _mm_shuffle_epi8(highTable, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble));
+                result                  = _mm_and_si128(result, _mm_and_si128(low, high));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buckets), result);
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(result, _mm_setzero_si128()))) ^ 0xffffu;
+        }
+#endif
+
+        /**
+         * @brief Find the first byte in the range [first, last) for which membership of the character class equals
+         * expected (i.e. the first byte in the class if expected is true, or the first byte not in it otherwise).
+         * With SSSE3, 16 bytes are classified at a time.
+         */
+        inline const unsigned char* findClassByte(const unsigned char* first,
+                                                  const unsigned char* last,
+                                                  const CharClass&     charClass,
+                                                  bool                 expected) {
+#if TROLDALGO_HAS_SSSE3
+            const unsigned flip = expected ? 0u : 0xffffu;
+            for (; last - first >= 16; first += 16) {
+                const auto mask = classMask16(first, charClass) ^ flip;
+                if (mask != 0)
+                    return first + countTrailingZeros(mask);
+            }
+#endif
+            for (; first != last; ++first)
+                if (charClass.contains(*first) == expected)
+                    return first;
+            return last;
+        }
+
+        /**
+         * @brief Find the last byte in the range [first, last) which is in the character class, or last if there is
+         * none. With SSSE3, 16 bytes are classified at a time.
+         */
+        inline const unsigned char* findLastClassByte(const unsigned char* first,
+                                                      const unsigned char* last,
+                                                      const CharClass&     charClass) {
+            auto* end = last;
+#if TROLDALGO_HAS_SSSE3
+            for (; end - first >= 16; end -= 16) {
+                const auto mask = classMask16(end - 16, charClass);
+                if (mask != 0)
+                    return end - 16 + highestSetBit(mask);
+            }
+#endif
+            while (end != first)
+                if (charClass.contains(*--end))
+                    return end;
+            return last;
+        }
+
+        /**
+         * @brief Find the first byte in the range [first, last) which equals any of the values in the range
+         * [v_first, v_last), which may hold at most 16 values. With SSE2, 16 bytes are compared with each value at a
+         * time; for small sets, this is faster than classifying them with table lookups.
+         */
+        inline const unsigned char* findAnyByte(const unsigned char* first,
+                                                const unsigned char* last,
+                                                const unsigned char* v_first,
+                                                const unsigned char* v_last) {
+#if TROLDALGO_HAS_SSE2
+            __m128i           values[16];
+            const std::size_t count = static_cast<std::size_t>(v_last - v_first);
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] = _mm_set1_epi8(static_cast<char>(v_first[i]));
+
+            for (; last - first >= 16; first += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                __m128i       match = _mm_setzero_si128();
+                for (std::size_t i = 0; i < count; ++i)
+                    match = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, values[i]));
+                const auto mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+                if (mask != 0)
+                    return first + countTrailingZeros(mask);
+            }
+#endif
+            for (; first != last; ++first)
+                if (std::find(v_first, v_last, *first) != v_last)
+                    return first;
+            return last;
+        }
+
+        /**
+         * @brief Kernel for find_if and find_if_not. A CharClass predicate on byte-sized elements is lowered to
+         * findClassByte; all other predicates are passed on to std::find_if or std::find_if_not.
+         */
+        template<typename Iter, typename UnaryPredicate>
+        Iter findIfKernel(Iter first, Iter last, UnaryPredicate& p, bool expected) {
+            if constexpr (std::is_pointer<Iter>::value && std::is_same<UnaryPredicate, CharClass>::value) {
+                if constexpr (IsByteComparable<std::remove_cv_t<std::remove_pointer_t<Iter>>>::value) {
+                    const auto* bytes = asBytes(first);
+                    return first + (findClassByte(bytes, bytes + (last - first), p, expected) - bytes);
+                }
+            }
+
+            return expected ? std::find_if(first, last, p) : std::find_if_not(first, last, p);
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::find_if. At compile time, a simple loop is used.
+         */
+        template<typename InputIt, typename UnaryPredicate>
+        constexpr InputIt find_if(InputIt first, InputIt last, UnaryPredicate p) {
+            if (isConstantEvaluated()) {
+                for (; first != last; ++first)
+                    if (p(*first))
+                        return first;
+                return last;
+            }
+
+            return lowerToPointers(first, last, [&](auto f, auto l) { return findIfKernel(f, l, p, true); });
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::find_if_not. At compile time, a simple loop is used.
+         */
+        template<typename InputIt, typename UnaryPredicate>
+        constexpr InputIt find_if_not(InputIt first, InputIt last, UnaryPredicate p) {
+            if (isConstantEvaluated()) {
+                for (; first != last; ++first)
+                    if (!p(*first))
+                        return first;
+                return last;
+            }
+
+            return lowerToPointers(first, last, [&](auto f, auto l) { return findIfKernel(f, l, p, false); });
+        }
+
+        /**
+         * @brief Convert an ASCII upper case letter to lower case. All other values are returned unchanged.
+         */
+        template<typename T>
+        constexpr T asciiLower(const T& value) {
+            return (value >= 'A' && value <= 'Z') ? narrow<T>(value | 0x20) : value;
+        }
+
+        /**
+         * @brief Get the bits to OR onto a byte before comparing it with value, ignoring ASCII case. For letters, this
+         * is 0x20, which maps both cases to lower case. As value is then a lower case letter, no other byte can
+         * compare equal after the OR. For all other values, the comparison is exact.
+         */
+        constexpr unsigned char asciiFoldBits(unsigned char value) {
+            return ((value | 0x20) >= 'a' && (value | 0x20) <= 'z') ? 0x20 : 0x00;
+        }
+
+        /**
+         * @brief Compare two byte sequences of the given length, ignoring ASCII case.
+         */
+        inline bool equalBytesIcase(const unsigned char* lhs, const unsigned char* rhs, std::size_t length) {
+            for (std::size_t i = 0; i < length; ++i)
+                if (asciiLower(lhs[i]) != asciiLower(rhs[i]))
+                    return false;
+            return true;
+        }
+
+        /**
+         * @brief Find the first byte equal to value in the range [first, last), ignoring ASCII case. With SSE2, the
+         * case is folded inside the vector compares, 16 bytes at a time.
+         */
+        inline const unsigned char* findByteIcase(const unsigned char* first, const unsigned char* last, unsigned char value) {
+            const unsigned char bits = asciiFoldBits(value);
+            if (bits == 0)
+                return findByte(first, last, value);
+
+            value = static_cast<unsigned char>(value | bits);
+#if TROLDALGO_HAS_SSE2
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+            const __m128i fold   = _mm_set1_epi8(static_cast<char>(bits));
+            for (; last - first >= 16; first += 16) {
+                const __m128i chunk = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), fold);
+                const auto    mask  = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+                if (mask != 0)
+                    return first + countTrailingZeros(mask);
+            }
+#endif
+            for (; first != last; ++first)
+                if ((*first | bits) == value)
+                    return first;
+            return last;
+        }
+
+        /**
+         * @brief Search for the first occurrence of the byte sequence [s_first, s_last) in the range [first, last),
+         * ignoring ASCII case.
+         * @details Candidates are positions where both the first and the last byte of the sequence match (with the
+         * case folded inside the compares); with SSE2, 16 candidate positions are tested at a time. The candidates are
+         * then verified byte by byte.
+         */
+        inline const unsigned char* searchBytesIcase(const unsigned char* first,
+                                                     const unsigned char* last,
+                                                     const unsigned char* s_first,
+                                                     const unsigned char* s_last) {
+            const auto length = s_last - s_first;
+            if (length == 0)
+                return first;
+            if (last - first < length)
+                return last;
+
+            const auto          headBits      = asciiFoldBits(*s_first);
+            const auto          tailBits      = asciiFoldBits(s_last[-1]);
+            const unsigned char head          = static_cast<unsigned char>(*s_first | headBits);
+            const unsigned char tail          = static_cast<unsigned char>(s_last[-1] | tailBits);
+            const auto*         candidateLast = last - length + 1;
+#if TROLDALGO_HAS_SSE2
+            const __m128i headNeedle = _mm_set1_epi8(static_cast<char>(head));
+            const __m128i tailNeedle = _mm_set1_epi8(static_cast<char>(tail));
+            const __m128i headFold   = _mm_set1_epi8(static_cast<char>(headBits));
+            const __m128i tailFold   = _mm_set1_epi8(static_cast<char>(tailBits));
+            for (; candidateLast - first >= 16; first += 16) {
+                const __m128i heads = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), headFold);
+                const __m128i tails = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + length - 1)),
+                                                   tailFold);
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi8(heads, headNeedle), _mm_cmpeq_epi8(tails, tailNeedle))));
+                for (; mask != 0; mask &= mask - 1) {
+                    const auto* candidate = first + countTrailingZeros(mask);
+                    if (equalBytesIcase(candidate, s_first, static_cast<std::size_t>(length)))
+                        return candidate;
+                }
+            }
+#endif
+            for (; first != candidateLast; ++first)
+                if ((*first | headBits) == head && (first[length - 1] | tailBits) == tail &&
+                    equalBytesIcase(first, s_first, static_cast<std::size_t>(length)))
+                    return first;
+            return last;
+        }
+
+        /**
+         * @brief Kernel for finding the first element equal to value, ignoring ASCII case. For raw pointers to bytes,
+         * findByteIcase is used.
+         */
+        template<typename Iter, typename T>
+        Iter findIcaseKernel(Iter first, Iter last, const T& value) {
+            using ValueType = typename std::iterator_traits<Iter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsByteComparable<ValueType>::value &&
+                          IsBlockComparable<T>::value) {
+                if (!isRepresentable<ValueType>(value))
+                    return last;
+
+                const auto* bytes = asBytes(first);
+                const auto  byte  = narrow<unsigned char>(narrow<ValueType>(value));
+                return first + (findByteIcase(bytes, bytes + (last - first), byte) - bytes);
+            }
+            else
+                return std::find_if(first, last, [&](const auto& elem) { return asciiLower(elem) == asciiLower(value); });
+        }
+
+        /**
+         * @brief Kernel for searching for a sequence, ignoring ASCII case. If both ranges are contiguous sequences of
+         * bytes, searchBytesIcase is used.
+         */
+        template<typename Iter, typename SeqIter>
+        Iter searchIcaseKernel(Iter first, Iter last, SeqIter s_first, SeqIter s_last) {
+            using ValueType    = typename std::iterator_traits<Iter>::value_type;
+            using SeqValueType = typename std::iterator_traits<SeqIter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsContiguousIterator<SeqIter>::value &&
+                          IsByteComparable<ValueType>::value && IsByteComparable<SeqValueType>::value &&
+                          std::is_signed<ValueType>::value == std::is_signed<SeqValueType>::value) {
+                if (s_first == s_last)
+                    return first;
+
+                const auto* bytes    = asBytes(first);
+                const auto* seqBytes = asBytes(std::addressof(*s_first));
+                const auto* result   = searchBytesIcase(bytes, bytes + (last - first), seqBytes, seqBytes + (s_last - s_first));
+                return first + (result - bytes);
+            }
+            else
+                return std::search(first, last, s_first, s_last, [](const auto& lhs, const auto& rhs) {
+                    return asciiLower(lhs) == asciiLower(rhs);
+                });
+        }
+
+        /**
+         * @brief Contiguous-aware function for finding the first element equal to value, ignoring ASCII case.
+         */
+        template<typename InputIt, typename T>
+        InputIt find_icase(InputIt first, InputIt last, const T& value) {
+            return lowerToPointers(first, last, [&](auto f, auto l) { return findIcaseKernel(f, l, value); });
+        }
+
+        /**
+         * @brief Contiguous-aware function for searching for a sequence, ignoring ASCII case.
+         */
+        template<typename ForwardIt1, typename ForwardIt2>
+        ForwardIt1 search_icase(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last) {
+            return lowerToPointers(first, last, [&](auto f, auto l) { return searchIcaseKernel(f, l, s_first, s_last); });
+        }
+
+        /**
+         * @brief Determine if a byte is a UTF-8 continuation byte, i.e. of the form 10xxxxxx.
+         */
+        constexpr bool isUtf8Continuation(unsigned char byte) {
+            return (byte & 0xC0) == 0x80;
+        }
+
+        /**
+         * @brief Find the start of the first invalid UTF-8 sequence in the range [first, last).
+         * @details The sequences are validated according to table 3-7 of the Unicode standard, i.e. overlong
+         * encodings, surrogates and code points above U+10FFFF are rejected. For raw pointers, runs of ASCII are
+         * skipped 16 bytes at a time.
+         */
+        template<typename Iter>
+        Iter findInvalidUtf8Kernel(Iter first, Iter last) {
+            while (first != last) {
+                if constexpr (std::is_pointer<Iter>::value) {
+                    for (; last - first >= 16; first += 16) {
+                        std::uint64_t words[2];
+                        std::memcpy(words, first, sizeof(words));
+                        if (((words[0] | words[1]) & 0x8080808080808080u) != 0)
+                            break;
+                    }
+                    if (first == last)
+                        break;
+                }
+
+                const auto lead = narrow<unsigned char>(*first);
+                if (lead < 0x80) {
+                    ++first;
+                    continue;
+                }
+
+                // ===== Determine the length of the sequence, and the valid range of the second byte.
+                int           length = 0;
+                unsigned char low    = 0x80;
+                unsigned char high   = 0xBF;
+                if (lead >= 0xC2 && lead <= 0xDF)
+                    length = 2;
+                else if (lead >= 0xE0 && lead <= 0xEF) {
+                    length = 3;
+                    if (lead == 0xE0) low = 0xA0;
+                    if (lead == 0xED) high = 0x9F;
+                }
+                else if (lead >= 0xF0 && lead <= 0xF4) {
+                    length = 4;
+                    if (lead == 0xF0) low = 0x90;
+                    if (lead == 0xF4) high = 0x8F;
+                }
+                else
+                    return first;
+
+                auto it = std::next(first);
+                for (int i = 1; i < length; ++i, ++it) {
+                    if (it == last)
+                        return first;
+                    const auto byte = narrow<unsigned char>(*it);
+                    if (byte < low || byte > high)
+                        return first;
+                    low  = 0x80;
+                    high = 0xBF;
+                }
+                first = it;
+            }
+
+            return last;
+        }
+
+#if TROLDALGO_HAS_MEMRCHR
+        /**
+         * @brief Find the last byte equal to value in the range [first, last), using memrchr.
+         * @details The last few bytes are examined with a simple loop, as the call overhead of memrchr dominates when
+         * the matches are close together.
+         * @return A pointer to the byte found; if none has been found, \c last will be returned.
+         */
+        inline const unsigned char* findLastByte(const unsigned char* first, const unsigned char* last, unsigned char value) {
+            const auto* suffixFirst = last - std::min<std::ptrdiff_t>(last - first, 16);
+            for (const auto* it = last; it != suffixFirst;)
+                if (*--it == value)
+                    return it;
+
+            const void* result = ::memrchr(first, value, static_cast<std::size_t>(suffixFirst - first));
+            return result ? static_cast<const unsigned char*>(result) : last;
+        }
+#endif
+
+        /**
+         * @brief Find the last element equal to value, in the range [first, last).
+         * @details For raw pointers to byte-sized elements, memrchr is used, if available. For raw pointers to other
+         * integral elements, the range is examined backwards in blocks of one cache line, without any branches inside
+         * the block, which allows the compiler to vectorize the loop.
+         * @return An iterator to the element found; if none has been found, \c last will be returned.
+         */
+        template<typename Iter, typename T>
+        Iter findLastKernel(Iter first, Iter last, const T& value) {
+            using ValueType = typename std::iterator_traits<Iter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsBlockComparable<ValueType>::value &&
+                          IsBlockComparable<T>::value) {
+                if (!isRepresentable<ValueType>(value))
+                    return last;
+
+#if TROLDALGO_HAS_MEMRCHR
+                if constexpr (IsByteComparable<ValueType>::value) {
+                    const auto* bytes = asBytes(first);
+                    const auto  byte  = narrow<unsigned char>(narrow<ValueType>(value));
+                    return first + (findLastByte(bytes, bytes + (last - first), byte) - bytes);
+                }
+#endif
+
+                constexpr std::ptrdiff_t BlockSize = 64 / sizeof(ValueType);
+                const auto               elem      = narrow<ValueType>(value);
+                auto                     end       = last;
+                while (end - first >= BlockSize) {
+                    unsigned match = 0;
+                    for (std::ptrdiff_t i = 0; i < BlockSize; ++i)
+                        match |= static_cast<unsigned>(end[i - BlockSize] == elem);
+                    if (match != 0)
+                        break;
+                    end -= BlockSize;
+                }
+
+                while (end != first)
+                    if (*--end == elem)
+                        return end;
+                return last;
+            }
+            else {
+                auto result = std::find(std::make_reverse_iterator(last), std::make_reverse_iterator(first), value);
+                return result.base() == first ? last : std::prev(result.base());
+            }
+        }
+
+        /**
+         * @brief Search for the last occurrence of the sequence [s_first, s_last) in the range [first, last).
+         * @details For raw pointers to integral elements, candidates are located backwards with findLastKernel, using
+         * the last element of the sequence.
+         * @return An iterator to the beginning of the occurrence found; if none has been found, \c last will be returned.
+         */
+        template<typename Iter, typename SeqIter>
+        Iter searchLastKernel(Iter first, Iter last, SeqIter s_first, SeqIter s_last) {
+            using ValueType    = typename std::iterator_traits<Iter>::value_type;
+            using SeqValueType = typename std::iterator_traits<SeqIter>::value_type;
+
+            if constexpr (std::is_pointer<Iter>::value && IsBlockComparable<ValueType>::value &&
+                          IsBlockComparable<SeqValueType>::value) {
+                const auto length = std::distance(s_first, s_last);
+                if (length == 0 || last - first < length)
+                    return last;
+
+                const auto& seqBack = *std::next(s_first, length - 1);
+                auto        end     = last;
+                while (end - first >= length) {
+                    auto candidate = findLastKernel(first + (length - 1), end, seqBack);
+                    if (candidate == end)
+                        break;
+                    if (std::equal(s_first, s_last, candidate - (length - 1)))
+                        return candidate - (length - 1);
+                    end = candidate;
+                }
+                return last;
+            }
+            else
+                return std::find_end(first, last, s_first, s_last);
+        }
+
+        /**
+         * @brief Contiguous-aware function for finding the last element equal to value.
+         */
+        template<typename BidirIt, typename T>
+        BidirIt find_last(BidirIt first, BidirIt last, const T& value) {
+            return lowerToPointers(first, last, [&](auto f, auto l) { return findLastKernel(f, l, value); });
+        }
+
+        /**
+         * @brief Contiguous-aware equivalent of std::find_end.
+         */
+        template<typename BidirIt, typename ForwardIt>
+        BidirIt search_last(BidirIt first, BidirIt last, ForwardIt s_first, ForwardIt s_last) {
+            return lowerToPointers(first, last, [&](auto f, auto l) { return searchLastKernel(f, l, s_first, s_last); });
+        }
+    }  // namespace detail
+
+    // ===== GENERIC FIND/SEARCH ALGORITHMS
+
+    /**
+     * @brief Finds all elements of a given value in a container, in the range [first, last).
+     * @details This algorithm is a wrapper around the std::find algorithm. It simply calls std::find on the provided
+     * container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of the letter 'A' in a given string. It will find four items at
+     * position 0, 7, 8 and 15. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all(str.begin(),str.end(), std::back_inserter(results), 'A');
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam T The type of the value to find. T will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param value The value to find.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename InputIt, typename OutputIt, typename T>
+    constexpr OutputIt find_all(InputIt first,
+                                InputIt last,
+                                OutputIt d_first,
+                                const T& value) {
+        while (first != last) {
+            first = detail::find(first, last, value);
+            if (first != last)
+                *(d_first++) = first++;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements of a given value in a container.
+     * @details For associative containers (see IsAssociativeContainer), such as std::multiset and
+     * std::unordered_multiset, the elements are looked up using the equal_range member function of the container,
+     * i.e. in O(log n + k) and O(1 + k) time respectively, instead of examining every element. The elements are
+     * found in the same order as when iterating through the container. For all other containers, this is equivalent
+     * to calling find_all on the begin/end iterators of the container.
+     * #### Example
+     * The following example will find all occurrences of the letter 'A' in a std::multiset, without visiting any of
+     * the other elements. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto set = std::multiset<char>{'A', 'B', 'C', 'A', 'X'};
+     *      std::vector<decltype(set.begin())> results;
+     *      trl::find_all(set, std::back_inserter(results), 'A');
+     *   @endcode
+     * @tparam Container The type of the container. Container will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam T The type of the value to find. T will be auto-deducted by the compiler.
+     * @param container The container to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param value The value to find.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, neither std::find nor equal_range are marked
+     * noexcept, so they might throw, but documentation does not reveal any details.
+     */
+    template<typename Container, typename OutputIt, typename T>
+    OutputIt find_all(Container& container,
+                      OutputIt d_first,
+                      const T& value) {
+
+        using ContainerType = std::remove_const_t<Container>;
+
+        // ===== The equal_range lookup is only used when the value has the key type of the container; otherwise, the
+        // ===== implicit conversion of the value may give different results from the element-wise comparison.
+        if constexpr (IsAssociativeContainer<ContainerType>::value) {
+            if constexpr (std::is_same<T, typename ContainerType::key_type>::value) {
+                auto range = container.equal_range(value);
+                for (auto it = range.first; it != range.second; ++it)
+                    *(d_first++) = it;
+
+                return d_first;
+            }
+            else
+                return find_all(container.begin(), container.end(), d_first, value);
+        }
+        else
+            return find_all(container.begin(), container.end(), d_first, value);
+    }
+
+    /**
+     * @brief Finds all elements of each of a set of values in a container, in the range [first, last), in a single pass.
+     * @details This is equivalent to calling trl::find_all once for each value, with the corresponding sink as the
+     * output, but the range is only examined once. The sinks are given as a range of output iterators (one for each
+     * value, in the same order), which are advanced in place as the elements are found. If a value occurs more than
+     * once in the set, its elements are only written to the first corresponding sink.
+     *
+     * For contiguous sequences of bytes (e.g. std::string), the elements not in the set are skipped 16 at a time:
+     * small sets (up to 16 values, or 4 with SSSE3) are found by comparing with each value using SSE2, and larger
+     * sets by turning them into a trl::CharClass for the SSSE3 classification kernel (if available). The sink of each
+     * element found is then looked up in a table. Otherwise, each element is compared with the values.
+     * #### Example
+     * The following example will find the positions of the commas (3 and 7) and of the newline (11) in a single pass.
+     *   @code{.cpp}
+     *      auto str = std::string("key,val,abc\n");
+     *      auto values = std::string(",\n");
+     *      std::vector<decltype(str.begin())> commas, newlines;
+     *      std::vector<std::back_insert_iterator<decltype(commas)>> sinks { std::back_inserter(commas), std::back_inserter(newlines) };
+     *      trl::find_all_grouped(str.begin(), str.end(), values.begin(), values.end(), sinks.begin());
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @tparam ForwardIt The type of the iterators to the values. ForwardIt will be auto-deducted by the compiler.
+     * @tparam SinkIt The type of the iterators to the sinks. This must be a random access iterator to mutable output
+     * iterators. SinkIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param v_first The first value to find.
+     * @param v_last One beyond the last value to find.
+     * @param s_first The sink of the first value.
+     * @return An iterator to one beyond the sink of the last value.
+     */
+    template<typename InputIt, typename ForwardIt, typename SinkIt>
+    SinkIt find_all_grouped(InputIt first,
+                            InputIt last,
+                            ForwardIt v_first,
+                            ForwardIt v_last,
+                            SinkIt s_first) {
+        using ValueType = typename std::iterator_traits<InputIt>::value_type;
+        static_assert(IsRandomAccessIterator<SinkIt>::value, "The sinks must be given as a random access range!");
+
+        const auto count = std::distance(v_first, v_last);
+
+        if constexpr (IsContiguousIterator<InputIt>::value && detail::IsByteComparable<ValueType>::value) {
+            // ===== Map each byte value to the index of its sink (or -1), and collect the values in a character class.
+            std::array<std::ptrdiff_t, 256> sinks;
+            sinks.fill(-1);
+            CharClass     members;
+            unsigned char distinct[256];
+            std::size_t   distinctCount = 0;
+            std::ptrdiff_t index = 0;
+            for (auto value = v_first; value != v_last; ++value, ++index) {
+                if (!detail::isRepresentable<ValueType>(*value))
+                    continue;
+                const auto byte = detail::narrow<unsigned char>(detail::narrow<ValueType>(*value));
+                if (sinks[byte] == -1) {
+                    sinks[byte]               = index;
+                    members                   = members | CharClass::range(byte, byte);
+                    distinct[distinctCount++] = byte;
+                }
+            }
+
+            // ===== Small sets are found by comparing with each value, as table lookups are only vectorized with SSSE3.
+            const bool compare = distinctCount <= (TROLDALGO_HAS_SSSE3 ? 4 : 16);
+            auto       find    = [&](const unsigned char* from, const unsigned char* to) {
+                return compare ? detail::findAnyByte(from, to, distinct, distinct + distinctCount)
+                                        : detail::findClassByte(from, to, members, true);
+            };
+
+            if (first != last) {
+                const auto* bytes = detail::asBytes(std::addressof(*first));
+                const auto* end   = bytes + (last - first);
+                for (auto* it = find(bytes, end); it != end; it = find(it + 1, end))
+                    *(s_first[sinks[*it]]++) = first + (it - bytes);
+            }
+        }
+        else {
+            for (; first != last; ++first) {
+                const auto value = std::find(v_first, v_last, *first);
+                if (value != v_last)
+                    *(s_first[std::distance(v_first, value)]++) = first;
+            }
+        }
+
+        return s_first + count;
+    }
+
+    /**
+     * @brief Finds all elements that satisfies a certain criteria (using a predicate) in the range [first, last) of a container.
+     * @details This algorithm is a wrapper around the std::find_if algorithm. It simply calls std::find_if on the provided
+     * container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of the letter 'A' in a given string. It will find four items at
+     * position 0, 7, 8 and 15. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all_if(str.begin(),str.end(), std::back_inserter(results), [](char c) {return c == 'A';});
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam UnaryPredicate The type of the predicate function. UnaryPredicate will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param p A unary predicate which returns ​true for the required element.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all_if itself does not throw. However, std::find_if is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename InputIt, typename OutputIt, typename UnaryPredicate>
+    constexpr OutputIt find_all_if(InputIt first,
+                                   InputIt last,
+                                   OutputIt d_first,
+                                   UnaryPredicate p) {
+        while (first != last) {
+            first = detail::find_if(first, last, p);
+            if (first != last)
+                *(d_first++) = first++;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements that does NOT satisfy a certain criteria (using a predicate) in the range [first, last) of a container.
+     * @details This algorithm is a wrapper around the std::find_if_not algorithm. It simply calls std::find_if_not on the provided
+     * container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of letters not equaling 'A' in a given string. It will find 13 items at
+     * position 1, 2, 3, 4, 5, 6, 9, 10, 11, 12, 13, 14 and 16. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::find_all_if_not(str.begin(),str.end(), std::back_inserter(results), [](char c) {return c == 'A';});
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam UnaryPredicate The type of the predicate function. UnaryPredicate will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param p A unary predicate which returns ​true for the required element.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all_if_not itself does not throw. However, std::find_if_not is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename InputIt, typename OutputIt, typename UnaryPredicate>
+    constexpr OutputIt find_all_if_not(InputIt first,
+                                       InputIt last,
+                                       OutputIt d_first,
+                                       UnaryPredicate p) {
+        while (first != last) {
+            first = detail::find_if_not(first, last, p);
+            if (first != last)
+                *(d_first++) = first++;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds the first elements that does NOT satisfy any of the given search elements, in the range [first, last) of a container.
+     * @details This algorithm is a wrapper around the std::find_if and std::find algorithm.
+     * #### Example
+     * The following example will find the first occurrence of a letter not equaling 'A' or 'B' in a given string. It will find
+     * it as index 2. An Iterator to the element will be returned.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      auto src = std::string("AB");
+     *      trl::find_first_not_of(str.begin(),str.end(), src.begin(), src.end());
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the range of elements to search for.
+     * @param s_last One element beyond the last element in the range to search for.
+     * @return An iterator pointing to the element found; if none has been found, \c last will be returned.
+     * @throws Undefined std::find_if and std::find does not throw. However, they is not marked noexcept, so they might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2>
+    constexpr ForwardIt1 find_first_not_of(ForwardIt1 first,
+                                           ForwardIt1 last,
+                                           ForwardIt2 s_first,
+                                           ForwardIt2 s_last) {
+
+        return detail::find_if(first, last, [&](const decltype(*first)& val) {
+            return (detail::find(s_first, s_last, val) == s_last);
+        });
+    }
+
+    /**
+     * @brief Finds the first element in the range [first, last) that does not equal any of the elements in the range
+     * [s_first, s_last), using a predicate to compare the elements.
+     * #### Example
+     * The following example will find the first occurrence of a letter not equaling 'a' or 'b' (ignoring case) in a
+     * given string. It will find it at index 2. An Iterator to the element will be returned.
+     *   @code{.cpp}
+     *      auto str = std::string("AbCDDCBAABCDDCBAX");
+     *      auto src = std::string("ab");
+     *      trl::find_first_not_of(str.begin(),str.end(), src.begin(), src.end(), [](char a, char b) { return (a | 0x20) == b; });
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam BinaryPredicate A binary predicate which returns ​true if the elements should be treated as equal.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the range of elements to search for.
+     * @param s_last One element beyond the last element in the range to search for.
+     * @param p A binary predicate which returns ​true if the elements should be treated as equal.
+     * @return An iterator pointing to the element found; if none has been found, \c last will be returned.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename BinaryPredicate>
+    constexpr ForwardIt1 find_first_not_of(ForwardIt1 first,
+                                           ForwardIt1 last,
+                                           ForwardIt2 s_first,
+                                           ForwardIt2 s_last,
+                                           BinaryPredicate p) {
+
+        return detail::find_if(first, last, [&](const decltype(*first)& val) {
+            for (auto it = s_first; it != s_last; ++it)
+                if (p(val, *it))
+                    return false;
+            return true;
+        });
+    }
+
+    /**
+     * @brief Finds all elements of a given range of value in a container, in the range [first, last).
+     * @details This algorithm is a wrapper around the std::find_first_of algorithm. It simply calls std::find_first_of
+     * on the provided container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of the letters {'A', 'B'} in a given string. It will find eight items at
+     * position 0, 1, 6, 7, 8, 9, 14 and 15. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      auto src = std::string("AB");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    constexpr OutputIt find_all_of(ForwardIt1 first,
+                                   ForwardIt1 last,
+                                   ForwardIt2 s_first,
+                                   ForwardIt2 s_last,
+                                   OutputIt d_first) {
+        while (first != last) {
+            first = detail::find_first_of(first, last, s_first, s_last);
+            if (first != last) {
+                *(d_first++) = first;
+                first++;
+            }
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements of a given range of value in a container, in the range [first, last), using a predicate.
+     * @details This algorithm is a wrapper around the std::find_first_of algorithm. It simply calls std::find_first_of
+     * on the provided container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of the letters {'A', 'B'} in a given string. It will find eight items at
+     * position 0, 1, 6, 7, 8, 9, 14 and 15. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      auto src = std::string("AB");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results), [](const char& a, const char& b) { return a == b; });
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam BinaryPredicate A binary predicate which returns ​true if the elements should be treated as equal.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param p A binary predicate which returns ​true if the elements should be treated as equal.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt, typename BinaryPredicate>
+    constexpr OutputIt find_all_of(ForwardIt1 first,
+                                   ForwardIt1 last,
+                                   ForwardIt2 s_first,
+                                   ForwardIt2 s_last,
+                                   OutputIt d_first,
+                                   BinaryPredicate p) {
+        while (first != last) {
+            first = detail::find_first_of(first, last, s_first, s_last, p);
+            if (first != last) {
+                *(d_first++) = first;
+                first++;
+            }
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements NOT in a given range of values in a container, in the range [first, last).
+     * @details This algorithm is a wrapper around the trl::find_first_not_of algorithm. It simply calls trl::find_first_not_of
+     * on the provided container, until all elements have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences NOT equal to the letters {'A', 'B'} in a given string. It will find
+     * nine items at position 2,3,4,5,10,11,12,13 and 16. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
      *      auto src = std::string("AB");
      *      std::vector<decltype(str.begin())> results;
-            trl::find_all_of(std::execution::par, str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
+            trl::find_all_of(std::execution::par, str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    constexpr OutputIt find_all_not_of(ForwardIt1 first,
+                                       ForwardIt1 last,
+                                       ForwardIt2 s_first,
+                                       ForwardIt2 s_last,
+                                       OutputIt d_first) {
+        while (first != last) {
+            first = find_first_not_of(first, last, s_first, s_last);
+            if (first != last) {
+                *(d_first++) = first;
+                first++;
+            }
+        }
+
+        return d_first;
+    }
+
+    // TODO(troldal): Implement trl::find_all_not_of with predicates
+
+    /**
+     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range [first, last).
+     * @details This algorithm is a wrapper around the std::search algorithm. It simply calls std::search
+     * on the provided container, until all occurrences have been found, or until the last element has been reached.
+     * If both ranges are contiguous sequences of bytes (e.g. std::string), the search is performed using memchr and
+     * memcmp, falling back to memmem when the first element of the sequence is frequent. An empty sequence is never found.
+     * #### Example
+     * The following example will find all occurrences of the sequence "HELLO" in a given string. It will find
+     * two items at position 2 and 9. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABHELLOAAHELLOBAX");
+     *      auto src = std::string("HELLO");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    constexpr OutputIt search_all(ForwardIt1 first,
+                                  ForwardIt1 last,
+                                  ForwardIt2 s_first,
+                                  ForwardIt2 s_last,
+                                  OutputIt d_first) {
+        if (s_first == s_last)
+            return d_first;
+
+        while (first != last) {
+            first = detail::search(first, last, s_first, s_last);
+            if (first != last) {
+                *(d_first++) = first;
+                std::advance(first, std::distance(s_first, s_last));
+            }
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range [first, last), using a predicate.
+     * @details This algorithm is a wrapper around the std::search algorithm. It simply calls std::search
+     * on the provided container, until all occurrences have been found, or until the last element has been reached.
+     * #### Example
+     * The following example will find all occurrences of the sequence "HELLO" in a given string. It will find
+     * two items at position 2 and 9. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABHELLOAAHELLOBAX");
+     *      auto src = std::string("HELLO");
+     *      std::vector<decltype(str.begin())> results;
+            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results), [&](const char& a, const char& b) { return a == b; });
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam BinaryPredicate A binary predicate which returns ​true if the elements should be treated as equal.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param p A binary predicate which returns ​true if the elements should be treated as equal.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
+     * but documentation does not reveal any details.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt, typename BinaryPredicate>
+    constexpr OutputIt search_all(ForwardIt1 first,
+                                  ForwardIt1 last,
+                                  ForwardIt2 s_first,
+                                  ForwardIt2 s_last,
+                                  OutputIt d_first,
+                                  BinaryPredicate p) {
+        if (s_first == s_last)
+            return d_first;
+
+        while (first != last) {
+            first = detail::search(first, last, s_first, s_last, p);
+            if (first != last) {
+                *(d_first++) = first;
+                std::advance(first, std::distance(s_first, s_last));
+            }
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements of a given value in a container, in the range [first, last), ignoring ASCII case.
+     * @details Only the ASCII letters are case folded, i.e. 'A' to 'Z' are treated as equal to 'a' to 'z'. For
+     * contiguous sequences of bytes (e.g. std::string), the case is folded inside the SSE2 compares, by OR'ing 0x20
+     * onto each byte when the value is a letter.
+     * #### Example
+     * The following example will find all occurrences of the letter 'a' or 'A' in a given string. It will find
+     * three items at position 0, 2 and 4.
+     *   @code{.cpp}
+     *      auto str = std::string("AbaBA");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::find_all_icase(str.begin(), str.end(), std::back_inserter(results), 'a');
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam T The type of the value to search for. T will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param value The value to search for.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename InputIt, typename OutputIt, typename T>
+    OutputIt find_all_icase(InputIt first,
+                            InputIt last,
+                            OutputIt d_first,
+                            const T& value) {
+        while (first != last) {
+            first = detail::find_icase(first, last, value);
+            if (first != last)
+                *(d_first++) = first++;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range
+     * [first, last), ignoring ASCII case.
+     * @details Only the ASCII letters are case folded. This is equivalent to calling trl::search_all with a
+     * case-insensitive predicate, but if both ranges are contiguous sequences of bytes, candidates are located 16
+     * positions at a time by comparing the first and last elements of the sequence (with the case folded inside the
+     * SSE2 compares), and only the candidates are compared element by element. An empty sequence is never found.
+     * #### Example
+     * The following example will find the two occurrences of "error" at position 0 and 12.
+     *   @code{.cpp}
+     *      auto str = std::string("ERROR: disk Error");
+     *      auto src = std::string("error");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all_icase(str.begin(), str.end(), src.begin(), src.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    OutputIt search_all_icase(ForwardIt1 first,
+                              ForwardIt1 last,
+                              ForwardIt2 s_first,
+                              ForwardIt2 s_last,
+                              OutputIt d_first) {
+        if (s_first == s_last)
+            return d_first;
+
+        while (first != last) {
+            first = detail::search_icase(first, last, s_first, s_last);
+            if (first != last) {
+                *(d_first++) = first;
+                std::advance(first, std::distance(s_first, s_last));
+            }
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Finds all elements of a given value in a container, in the range [first, last), starting from the end.
+     * @details This algorithm is the reverse counterpart of trl::find_all. The range is examined from \c last towards
+     * \c first, and iterators to the elements found are copied to the output in reverse order, i.e. the last element
+     * first. The search stops when max_count elements have been found, so the work done is proportional to the distance
+     * from the end of the range to the last element found. For contiguous byte sequences, memrchr is used, if available.
+     * #### Example
+     * The following example will find the last two occurrences of the letter 'A' in a given string. It will find two
+     * items at position 15 and 8 (in that order). Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::find_all_reverse(str.begin(),str.end(), std::back_inserter(results), 'A', 2);
+     *   @endcode
+     * @tparam BidirIt The type of the input iterator parameters. BidirIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @tparam T The type of the value to find. T will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param value The value to find.
+     * @param max_count The maximum number of elements to find. By default, all elements are found.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined find_all_reverse itself does not throw. However, std::find is not marked noexcept, so it might
+     * throw, but documentation does not reveal any details.
+     */
+    template<typename BidirIt, typename OutputIt, typename T>
+    OutputIt find_all_reverse(BidirIt first,
+                              BidirIt last,
+                              OutputIt d_first,
+                              const T& value,
+                              std::size_t max_count = std::numeric_limits<std::size_t>::max()) {
+        for (; max_count > 0; --max_count) {
+            auto found = detail::find_last(first, last, value);
+            if (found == last)
+                break;
+            *(d_first++) = found;
+            last = found;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range [first, last),
+     * starting from the end.
+     * @details This algorithm is the reverse counterpart of trl::search_all. The range is examined from \c last towards
+     * \c first, and iterators to the occurrences found are copied to the output in reverse order, i.e. the last
+     * occurrence first. As the occurrences are non-overlapping from the end, they may differ from those found by
+     * trl::search_all for self-overlapping sequences (e.g. "AA" in "AAA"). The search stops when max_count occurrences
+     * have been found. An empty sequence is never found.
+     * #### Example
+     * The following example will find the last occurrence of the sequence "HELLO" in a given string, at position 9.
+     * An iterator to the element will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABHELLOAAHELLOBAX");
+     *      auto src = std::string("HELLO");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all_reverse(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results), 1);
+     *   @endcode
+     * @tparam BidirIt The type of the input iterator parameters. BidirIt will be auto-deducted by the compiler.
+     * @tparam ForwardIt The type of the search iterator parameters. ForwardIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param max_count The maximum number of occurrences to find. By default, all occurrences are found.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     * @throws Undefined search_all_reverse itself does not throw. However, std::find_end is not marked noexcept, so it
+     * might throw, but documentation does not reveal any details.
+     */
+    template<typename BidirIt, typename ForwardIt, typename OutputIt>
+    OutputIt search_all_reverse(BidirIt first,
+                                BidirIt last,
+                                ForwardIt s_first,
+                                ForwardIt s_last,
+                                OutputIt d_first,
+                                std::size_t max_count = std::numeric_limits<std::size_t>::max()) {
+        if (s_first == s_last)
+            return d_first;
+
+        for (; max_count > 0; --max_count) {
+            auto found = detail::search_last(first, last, s_first, s_last);
+            if (found == last)
+                break;
+            *(d_first++) = found;
+            last = found;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief Search for all non-overlapping occurrences of a pattern in a container, in the range [first, last), using a
+     * searcher object.
+     * @details The searcher is called as searcher(first, last), and must return a std::pair of iterators to the
+     * beginning and end of the first match, or a pair of \c last if there is none. This is the interface of the
+     * standard library searchers (e.g. std::boyer_moore_horspool_searcher), as well as trl::ShiftOrSearcher. The
+     * search is stopped if the searcher reports an empty match, i.e. an empty pattern is never found.
+     * #### Example
+     * The following example will find all occurrences of the sequence "HELLO" in a given string. It will find
+     * two items at position 2 and 9. Iterators to those elements will be copied to the results vector.
+     *   @code{.cpp}
+     *      auto str = std::string("ABHELLOAAHELLOBAX");
+     *      auto src = std::string("HELLO");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all(str.begin(), str.end(), trl::ShiftOrSearcher(src.begin(), src.end()), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt The type of the input iterator parameters. ForwardIt will be auto-deducted by the compiler.
+     * @tparam Searcher The type of the searcher. Searcher will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param searcher The searcher object.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename ForwardIt, typename Searcher, typename OutputIt>
+    constexpr OutputIt search_all(ForwardIt first,
+                                  ForwardIt last,
+                                  const Searcher& searcher,
+                                  OutputIt d_first) {
+        while (first != last) {
+            auto match = searcher(first, last);
+            if (match.first == last || match.first == match.second)
+                break;
+            *(d_first++) = match.first;
+            first = match.second;
+        }
+
+        return d_first;
+    }
+
+    /**
+     * @brief A searcher implementing the Shift-Or (bitap) algorithm, for patterns of up to 64 elements.
+     * @details The state of the search is held in a 64-bit word, which is updated with a single table lookup, a shift
+     * and an OR for each element in the input, with no data-dependent branches except when a match is found. This
+     * makes it well suited for short patterns, where skip-based searchers (e.g. Boyer-Moore) can barely skip, and
+     * for patterns with frequent elements. For literal patterns starting with a rare element, the default
+     * trl::search_all (which skips ahead with memchr) is usually faster.
+     *
+     * The elements of the text and the pattern must be byte-sized (e.g. char), as the table has an entry for each byte
+     * value. Each element of the pattern may also be a trl::CharClass, matching any byte in the class.
+     *
+     * The searcher follows the interface of the standard library searchers, and can be used with trl::search_all, as
+     * well as with std::search.
+     * #### Example
+     * The following example will search for a digit, followed by "px".
+     *   @code{.cpp}
+     *      auto pattern = std::vector<trl::CharClass> { trl::CharClass::digit(), trl::CharClass::of("p"), trl::CharClass::of("x") };
+     *      auto searcher = trl::ShiftOrSearcher(pattern.begin(), pattern.end());
+     *   @endcode
+     * @tparam ForwardIt The type of the pattern iterators.
+     */
+    template<typename ForwardIt>
+    class ShiftOrSearcher
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking the pattern as parameters.
+         * @param pat_first The first element in the pattern.
+         * @param pat_last One element beyond the last element in the pattern.
+         * @throws std::length_error if the pattern is longer than 64 elements.
+         */
+        ShiftOrSearcher(ForwardIt pat_first, ForwardIt pat_last)
+            : m_length(std::distance(pat_first, pat_last)) {
+
+            using PatternType = typename std::iterator_traits<ForwardIt>::value_type;
+            static_assert(std::is_same<PatternType, CharClass>::value || detail::IsByteComparable<PatternType>::value,
+                          "The ShiftOrSearcher pattern must consist of bytes or trl::CharClass elements!");
+
+            if (m_length > 64)
+                throw std::length_error("The ShiftOrSearcher pattern can not be longer than 64 elements.");
+
+            // ===== For each byte value, clear the bit of each pattern position that the byte matches.
+            std::fill(std::begin(m_masks), std::end(m_masks), ~std::uint64_t(0));
+            std::uint64_t bit = 1;
+            for (; pat_first != pat_last; ++pat_first, bit <<= 1) {
+                if constexpr (std::is_same<PatternType, CharClass>::value) {
+                    for (unsigned value = 0; value < 256; ++value)
+                        if (pat_first->contains(static_cast<unsigned char>(value)))
+                            m_masks[value] &= ~bit;
+                }
+                else
+                    m_masks[detail::narrow<unsigned char>(*pat_first)] &= ~bit;
+            }
+        }
+
+        /**
+         * @brief Search for the first occurrence of the pattern in the range [first, last).
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @return A std::pair of iterators to the beginning and end of the first match. If no match was found, a pair
+         * of \c last is returned. If the pattern is empty, a pair of \c first is returned.
+         * @note For forward iterators, the start of the match is tracked by a second iterator during the scan; for
+         * bidirectional iterators, it is found by stepping back from the end of the match.
+         */
+        template<typename ForwardIt2>
+        std::pair<ForwardIt2, ForwardIt2> operator()(ForwardIt2 first, ForwardIt2 last) const {
+            static_assert(detail::IsByteComparable<typename std::iterator_traits<ForwardIt2>::value_type>::value,
+                          "The ShiftOrSearcher can only search sequences of bytes!");
+
+            if (m_length == 0)
+                return {first, first};
+
+            // ===== Forward iterators can not step back from the end of the match, so the start is tracked while scanning.
+            using Category = typename std::iterator_traits<ForwardIt2>::iterator_category;
+            if constexpr (!std::is_base_of<std::bidirectional_iterator_tag, Category>::value)
+                return findMatch(first, last);
+            else {
+                auto matchEnd = detail::lowerToPointers(first, last, [&](auto f, auto l) { return findEnd(f, l); });
+                if (matchEnd == last)
+                    return {last, last};
+
+                ++matchEnd;
+                return {std::prev(matchEnd, m_length), matchEnd};
+            }
+        }
+
+    private:
+
+        /**
+         * @brief Find the first match in the range [first, last), keeping an iterator m_length elements behind the
+         * current element, so that the start of the match is known without stepping back.
+         */
+        template<typename Iter>
+        std::pair<Iter, Iter> findMatch(Iter first, Iter last) const {
+            const std::uint64_t matchBit = std::uint64_t(1) << (m_length - 1);
+            std::uint64_t       state    = ~std::uint64_t(0);
+            std::ptrdiff_t      lag      = 0;
+            for (auto start = first; first != last;) {
+                state = (state << 1) | m_masks[detail::narrow<unsigned char>(*first)];
+                ++first;
+                if (lag < m_length)
+                    ++lag;
+                else
+                    ++start;
+                if ((state & matchBit) == 0)
+                    return {start, first};
+            }
+            return {last, last};
+        }
+
+        /**
+         * @brief Find the last element of the first match in the range [first, last), or last if there is none.
+         */
+        template<typename Iter>
+        Iter findEnd(Iter first, Iter last) const {
+            const std::uint64_t matchBit = std::uint64_t(1) << (m_length - 1);
+            std::uint64_t       state    = ~std::uint64_t(0);
+            for (; first != last; ++first) {
+                state = (state << 1) | m_masks[detail::narrow<unsigned char>(*first)];
+                if ((state & matchBit) == 0)
+                    return first;
+            }
+            return last;
+        }
+
+        std::ptrdiff_t m_length;         /**< The length of the pattern. */
+        std::uint64_t  m_masks[256] = {}; /**< For each byte value, a bitmask with the non-matching positions set. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Compute the Horspool shift table of a literal at compile time. The entry of each byte value is the
+         * distance from its last occurrence in the literal (not counting the final byte) to the end of the literal,
+         * capped at 255.
+         */
+        template<char... Chars>
+        constexpr std::array<std::uint8_t, 256> literalShifts() {
+            constexpr char        literal[] = {Chars...};
+            constexpr std::size_t length    = sizeof...(Chars);
+
+            std::array<std::uint8_t, 256> shifts {};
+            for (auto& shift : shifts)
+                shift = static_cast<std::uint8_t>(std::min<std::size_t>(length, 255));
+            for (std::size_t i = 0; i + 1 < length; ++i)
+                shifts[static_cast<unsigned char>(literal[i])] =
+                    static_cast<std::uint8_t>(std::min<std::size_t>(length - 1 - i, 255));
+            return shifts;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief A searcher for a literal which is fixed at compile time, given as a pack of characters.
+     * @details All tables are computed at compile time, so constructing the searcher costs nothing, and the
+     * verification of a candidate is unrolled for the exact length of the literal. For contiguous sequences, with SSE2,
+     * the candidates of 16 positions are found at a time by comparing both the first and the last byte of the literal;
+     * otherwise (and for the final positions), the Horspool algorithm is used, with a shift table computed at compile
+     * time. With C++20, trl::StringSearcher allows the literal to be given as a string, and trl::search_all can be
+     * called with the literal as a template argument.
+     *
+     * The literal is compared byte by byte, so the elements of the text must be byte-sized (e.g. char). The searcher
+     * follows the interface of the standard library searchers, and can be used with trl::search_all, as well as with
+     * std::search.
+     * #### Example
+     *   @code{.cpp}
+     *      auto searcher = trl::LiteralSearcher<'\r', '\n'>();
+     *   @endcode
+     * @tparam Chars The characters of the literal, which can not be empty.
+     */
+    template<char... Chars>
+    class LiteralSearcher
+    {
+        static_assert(sizeof...(Chars) > 0, "The LiteralSearcher literal can not be empty!");
+
+    public:
+
+        /**
+         * @brief Search for the first occurrence of the literal in the range [first, last).
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @return A std::pair of iterators to the beginning and end of the first match. If no match was found, a pair
+         * of \c last is returned.
+         */
+        template<typename ForwardIt>
+        constexpr std::pair<ForwardIt, ForwardIt> operator()(ForwardIt first, ForwardIt last) const {
+            static_assert(detail::IsByteComparable<typename std::iterator_traits<ForwardIt>::value_type>::value,
+                          "The LiteralSearcher can only search sequences of bytes!");
+
+            ForwardIt match = last;
+            if constexpr (IsContiguousIterator<ForwardIt>::value) {
+                if (detail::isConstantEvaluated())
+                    match = findHorspool(first, last);
+                else
+                    match = detail::lowerToPointers(first, last, [](auto f, auto l) {
+                        const auto* bytes = detail::asBytes(f);
+                        return f + (findBytes(bytes, bytes + (l - f)) - bytes);
+                    });
+            }
+            else if constexpr (IsRandomAccessIterator<ForwardIt>::value)
+                match = findHorspool(first, last);
+            else
+                match = std::search(first, last, std::begin(Literal), std::end(Literal), [](const auto& lhs, char rhs) {
+                    return detail::narrow<unsigned char>(lhs) == static_cast<unsigned char>(rhs);
+                });
+
+            if (match == last)
+                return {last, last};
+            return {match, std::next(match, Length)};
+        }
+
+    private:
+
+        /**
+         * @brief Determine if the literal occurs at the given position, comparing all elements without a loop.
+         */
+        template<typename Iter, std::size_t... Indices>
+        static constexpr bool matches(Iter position, std::index_sequence<Indices...>) {
+            return ((detail::narrow<unsigned char>(position[Indices]) == static_cast<unsigned char>(Literal[Indices])) && ...);
+        }
+
+        /**
+         * @brief Find the first occurrence of the literal in the range [first, last), using the Horspool algorithm.
+         */
+        template<typename Iter>
+        static constexpr Iter findHorspool(Iter first, Iter last) {
+            while (last - first >= Length) {
+                if (matches(first, std::make_index_sequence<sizeof...(Chars)>()))
+                    return first;
+                first += Shifts[detail::narrow<unsigned char>(first[Length - 1])];
+            }
+            return last;
+        }
+
+        /**
+         * @brief Find the first occurrence of the literal in the byte range [first, last). A literal of one byte is
+         * found with memchr.
+         */
+        static const unsigned char* findBytes(const unsigned char* first, const unsigned char* last) {
+            if constexpr (Length == 1)
+                return detail::findByte(first, last, static_cast<unsigned char>(Literal[0]));
+            else {
+#if TROLDALGO_HAS_SSE2
+                if (last - first >= Length + 15) {
+                    const __m128i head      = _mm_set1_epi8(Literal[0]);
+                    const __m128i tail      = _mm_set1_epi8(Literal[Length - 1]);
+                    const auto*   blockLast = last - (Length + 15);
+                    for (; first <= blockLast; first += 16) {
+                        const __m128i heads = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                        const __m128i tails = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + Length - 1));
+                        auto          mask  = static_cast<unsigned>(_mm_movemask_epi8(
+                            _mm_and_si128(_mm_cmpeq_epi8(heads, head), _mm_cmpeq_epi8(tails, tail))));
+                        for (; mask != 0; mask &= mask - 1) {
+                            const auto* candidate = first + detail::countTrailingZeros(mask);
+                            if (matches(candidate, std::make_index_sequence<sizeof...(Chars)>()))
+                                return candidate;
+                        }
+                    }
+                }
+#endif
+                return findHorspool(first, last);
+            }
+        }
+
+        static constexpr std::ptrdiff_t Length    = static_cast<std::ptrdiff_t>(sizeof...(Chars)); /**< The length of the literal. */
+        static constexpr char           Literal[] = {Chars...}; /**< The characters of the literal. */
+        static constexpr std::array<std::uint8_t, 256> Shifts = detail::literalShifts<Chars...>(); /**< The Horspool shift table. */
+    };
+
+    /**
+     * @brief Finds all non-overlapping occurrences of a literal which is fixed at compile time, in the range
+     * [first, last).
+     * @details This is a shorthand for calling trl::search_all with a trl::LiteralSearcher. As the literal is a
+     * template argument, there is no setup at runtime, and the search loops are specialized for the literal.
+     * #### Example
+     * The following example will find the line breaks at positions 4 and 10.
+     *   @code{.cpp}
+     *      auto str = std::string("line\r\nline\r\n");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all<'\r', '\n'>(str.begin(), str.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam Chars The characters of the literal, which can not be empty.
+     * @tparam ForwardIt The type of the input iterator parameters. ForwardIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<char... Chars, typename ForwardIt, typename OutputIt>
+    constexpr OutputIt search_all(ForwardIt first, ForwardIt last, OutputIt d_first) {
+        return search_all(first, last, LiteralSearcher<Chars...>(), d_first);
+    }
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    /**
+     * @brief A string literal which can be used as a template argument (C++20). The terminating null character is
+     * not part of the string.
+     * @tparam N The size of the string literal, including the terminating null character.
+     */
+    template<std::size_t N>
+    struct FixedString
+    {
+        /**
+         * @brief Constructor, taking a string literal. It is implicit, so that a string literal can be used directly
+         * as a template argument.
+         */
+        constexpr FixedString(const char (&string)[N]) {
+            for (std::size_t i = 0; i < N; ++i)
+                data[i] = string[i];
+        }
+
+        char data[N] = {}; /**< The characters of the string, including the terminating null character. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Instantiate a template taking a pack of characters, with the characters of a FixedString.
+         */
+        template<FixedString String,
+                 template<char...> typename Template,
+                 typename Indices = std::make_index_sequence<sizeof(String.data) - 1>>
+        struct ExpandString;
+
+        template<FixedString String, template<char...> typename Template, std::size_t... Indices>
+        struct ExpandString<String, Template, std::index_sequence<Indices...>>
+        {
+            using type = Template<String.data[Indices]...>;
+        };
+    }  // namespace detail
+
+    /**
+     * @brief A trl::LiteralSearcher for a string literal given as a template argument (C++20), e.g.
+     * trl::StringSearcher<"ERROR">.
+     */
+    template<FixedString String>
+    using StringSearcher = typename detail::ExpandString<String, LiteralSearcher>::type;
+
+    /**
+     * @brief Finds all non-overlapping occurrences of a string literal given as a template argument (C++20), e.g.
+     * trl::search_all<"\r\n">(str.begin(), str.end(), std::back_inserter(results)).
+     * @details This is a shorthand for calling trl::search_all with a trl::StringSearcher.
+     */
+    template<FixedString String, typename ForwardIt, typename OutputIt>
+    constexpr OutputIt search_all(ForwardIt first, ForwardIt last, OutputIt d_first) {
+        return search_all(first, last, StringSearcher<String>(), d_first);
+    }
+#endif
+
+    /**
+     * @brief A searcher for the first occurrence of any of a set of literals, using the Teddy algorithm.
+     * @details The literals are distributed over eight buckets, and a fingerprint of the first one to four bytes of
+     * each literal (depending on the length of the shortest literal) is encoded as a set of nibble masks. With SSSE3,
+     * the candidate buckets of 16 positions are computed at a time with a few byte shuffles, without any table walk;
+     * only the literals in the candidate buckets are compared in full. If SSSE3 is not enabled at compile time, the
+     * kernel is still used with GCC and Clang on x86 if the processor supports it (see TROLDALGO_HAS_SSSE3_DISPATCH).
+     * Otherwise (or for non-contiguous input), the same masks are evaluated for one position at a time. This makes the searcher well suited for small sets
+     * (up to about 64) of short literals, e.g. log levels or HTTP verbs; for large sets, most positions become
+     * candidates.
+     *
+     * At each position, the longest literal is matched, and the match which starts first is found, i.e. the matches
+     * are leftmost-longest. Empty literals are ignored. The elements of the text must be byte-sized (e.g. char).
+     *
+     * The searcher follows the interface of the standard library searchers, and can be used with trl::search_all, as
+     * well as with std::search. trl::search_all_of is a shorthand for the former.
+     * #### Example
+     *   @code{.cpp}
+     *      auto searcher = trl::TeddySearcher({"GET", "POST", "PUT", "DELETE"});
+     *   @endcode
+     */
+    class TeddySearcher
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking the range of literals as parameters.
+         * @tparam ForwardIt The type of the iterators to the literals. Each literal must be a container of bytes (e.g.
+         * std::string or std::string_view). ForwardIt will be auto-deducted by the compiler.
+         * @param n_first The first literal.
+         * @param n_last One beyond the last literal.
+         */
+        template<typename ForwardIt>
+        TeddySearcher(ForwardIt n_first, ForwardIt n_last)
+            : m_literals(),
+              m_buckets(),
+              m_fingerprint(0) {
+
+            for (; n_first != n_last; ++n_first) {
+                static_assert(detail::IsByteComparable<std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(*n_first))>>>::value,
+                              "The TeddySearcher literals must consist of bytes!");
+                std::string literal;
+                for (const auto& elem : *n_first)
+                    literal += static_cast<char>(detail::narrow<unsigned char>(elem));
+                if (!literal.empty())
+                    m_literals.push_back(std::move(literal));
+            }
+
+            build();
+        }
+
+        /**
+         * @brief Constructor, taking the literals as an initializer list.
+         * @param literals The literals.
+         */
+        TeddySearcher(std::initializer_list<std::string> literals)
+            : TeddySearcher(literals.begin(), literals.end()) {}
+
+        /**
+         * @brief Search for the first occurrence of any of the literals in the range [first, last).
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @return A std::pair of iterators to the beginning and end of the first (and longest) match. If no match was
+         * found, a pair of \c last is returned.
+         */
+        template<typename ForwardIt2>
+        std::pair<ForwardIt2, ForwardIt2> operator()(ForwardIt2 first, ForwardIt2 last) const {
+            static_assert(detail::IsByteComparable<typename std::iterator_traits<ForwardIt2>::value_type>::value,
+                          "The TeddySearcher can only search sequences of bytes!");
+
+            std::size_t length = 0;
+            auto        found  = detail::lowerToPointers(first, last, [&](auto f, auto l) { return find(f, l, length); });
+            if (found == last)
+                return {last, last};
+
+            return {found, std::next(found, static_cast<std::ptrdiff_t>(length))};
+        }
+
+        /**
+         * @brief Get the literals, in the order they were given (without any empty literals).
+         */
+        [[nodiscard]] const std::vector<std::string>& literals() const {
+            return m_literals;
+        }
+
+    private:
+
+        /**
+         * @brief Distribute the literals over the buckets, and build the nibble masks of the fingerprints.
+         */
+        void build() {
+            if (m_literals.empty())
+                return;
+
+            std::size_t shortest = m_literals.front().size();
+            for (const auto& literal : m_literals)
+                shortest = std::min(shortest, literal.size());
+            m_fingerprint = static_cast<int>(std::min<std::size_t>(shortest, 4));
+
+            // ===== Literals with the same fingerprint are put in the same bucket, to limit the false candidates. The
+            // ===== literals are spread evenly over the buckets, but a bucket only changes between fingerprints.
+            std::vector<std::size_t> order(m_literals.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            const auto prefix = static_cast<std::size_t>(m_fingerprint);
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return m_literals[a].compare(0, prefix, m_literals[b], 0, prefix) < 0;
+            });
+
+            std::size_t bucket = 0;
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                const auto& literal = m_literals[order[i]];
+                if (i > 0 && literal.compare(0, prefix, m_literals[order[i - 1]], 0, prefix) != 0)
+                    bucket = std::max(bucket, i * 8 / order.size());
+                m_buckets[bucket].push_back(order[i]);
+                for (std::size_t k = 0; k < prefix; ++k) {
+                    const auto byte = static_cast<unsigned char>(literal[k]);
+                    m_masks[k][byte & 15] |= static_cast<unsigned char>(1u << bucket);
+                    m_masks[k][16 + (byte >> 4)] |= static_cast<unsigned char>(1u << bucket);
+                }
+            }
+
+            // ===== The longest literals in each bucket are compared first.
+            for (auto& members : m_buckets)
+                std::stable_sort(members.begin(), members.end(), [&](std::size_t a, std::size_t b) {
+                    return m_literals[a].size() > m_literals[b].size();
+                });
+        }
+
+        /**
+         * @brief Find the first position in the range [first, last) where a literal matches, and the length of the
+         * longest literal matching there.
+         */
+        template<typename Iter>
+        Iter find(Iter first, Iter last, std::size_t& length) const {
+            if (m_fingerprint == 0)
+                return last;
+
+            if constexpr (std::is_pointer<Iter>::value) {
+#if TROLDALGO_HAS_SSSE3 || TROLDALGO_HAS_SSSE3_DISPATCH
+                if (detail::hasSsse3()) {
+                    const auto* bytes = detail::asBytes(first);
+                    const bool  found = findBlocks(bytes, bytes + (last - first), length);
+                    first += bytes - detail::asBytes(first);
+                    if (found)
+                        return first;
+                }
+#endif
+            }
+
+            for (; first != last; ++first) {
+                unsigned buckets = 0xff;
+                auto     it      = first;
+                for (int k = 0; k < m_fingerprint && buckets != 0; ++k, ++it) {
+                    if (it == last)
+                        return last;
+                    const auto byte = detail::narrow<unsigned char>(*it);
+                    buckets &= static_cast<unsigned>(m_masks[k][byte & 15] & m_masks[k][16 + (byte >> 4)]);
+                }
+                if (buckets != 0 && verify(first, last, buckets, length))
+                    return first;
+            }
+            return last;
+        }
+
+#if TROLDALGO_HAS_SSSE3 || TROLDALGO_HAS_SSSE3_DISPATCH
+        /**
+         * @brief Find the first match in the range [position, last) which starts in a full block of 16 positions,
+         * using the Teddy kernel. If one is found, position is set to it; otherwise, it is set to the first position
+         * which has not been examined.
+         */
+        TROLDALGO_SSSE3_TARGET bool findBlocks(const unsigned char*& position, const unsigned char* last, std::size_t& length) const {
+            unsigned char buckets[16];
+            for (; last - position >= 15 + m_fingerprint; position += 16) {
+                for (auto mask = detail::teddyMask16(position, m_masks, m_fingerprint, buckets); mask != 0; mask &= mask - 1) {
+                    const auto lane = detail::countTrailingZeros(mask);
+                    if (verify(position + lane, last, buckets[lane], length)) {
+                        position += lane;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+#endif
+
+        /**
+         * @brief Compare the literals in the candidate buckets with the range starting at position. If any of them
+         * match, the length of the longest one is stored in length.
+         */
+        template<typename Iter>
+        bool verify(Iter position, Iter last, unsigned buckets, std::size_t& length) const {
+            bool found = false;
+            for (; buckets != 0; buckets &= buckets - 1) {
+                for (auto index : m_buckets[static_cast<std::size_t>(detail::countTrailingZeros(buckets))]) {
+                    const auto& literal = m_literals[index];
+                    if (found && literal.size() <= length)
+                        break;
+                    if (matches(position, last, literal)) {
+                        length = literal.size();
+                        found  = true;
+                        break;
+                    }
+                }
+            }
+            return found;
+        }
+
+        /**
+         * @brief Determine if the literal matches the range starting at position.
+         */
+        template<typename Iter>
+        static bool matches(Iter position, Iter last, const std::string& literal) {
+            if constexpr (std::is_pointer<Iter>::value) {
+                return static_cast<std::size_t>(last - position) >= literal.size() &&
+                       std::memcmp(position, literal.data(), literal.size()) == 0;
+            }
+            else {
+                for (auto c : literal) {
+                    if (position == last || detail::narrow<unsigned char>(*position) != static_cast<unsigned char>(c))
+                        return false;
+                    ++position;
+                }
+                return true;
+            }
+        }
+
+        std::vector<std::string>              m_literals;        /**< The literals. */
+        std::array<std::vector<std::size_t>, 8> m_buckets;       /**< The indices of the literals in each bucket. */
+        unsigned char                         m_masks[4][32] = {}; /**< For each fingerprint byte, the buckets of each low (first 16) and high nibble. */
+        int                                   m_fingerprint;     /**< The number of bytes in the fingerprints. */
+    };
+
+    /**
+     * @brief Search for all non-overlapping occurrences of any of a set of literals in a container, in the range
+     * [first, last).
+     * @details This is equivalent to trl::search_all with a trl::TeddySearcher for the literals: the matches are
+     * leftmost-longest, and the search continues after the end of each match. As all literals are searched for in a
+     * single pass, this is much faster than calling trl::search_all for each literal. To find which literal matched,
+     * compare the length of the matches, or use trl::search_all with the searcher directly.
+     * #### Example
+     * The following example will find "GET" at position 0, "POST" at position 11 and "GET" at position 21.
+     *   @code{.cpp}
+     *      auto str = std::string("GET /a.js, POST /form, GET /");
+     *      auto verbs = std::vector<std::string> { "GET", "POST", "PUT" };
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all_of(str.begin(), str.end(), verbs.begin(), verbs.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the iterators to the literals. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param n_first The first literal.
+     * @param n_last One beyond the last literal.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    OutputIt search_all_of(ForwardIt1 first,
+                           ForwardIt1 last,
+                           ForwardIt2 n_first,
+                           ForwardIt2 n_last,
+                           OutputIt d_first) {
+        return search_all(first, last, TeddySearcher(n_first, n_last), d_first);
+    }
+
+    /**
+     * @brief Hit, miss and eviction counts of a trl::SearcherCache.
+     */
+    struct SearcherCacheStatistics
+    {
+        std::uint64_t hits;      /**< The number of lookups which found a cached searcher. */
+        std::uint64_t misses;    /**< The number of lookups which compiled a new searcher. */
+        std::uint64_t evictions; /**< The number of searchers evicted to stay within the capacity. */
+    };
+
+    /**
+     * @brief A thread-safe, bounded cache of compiled searchers, keyed by the content of the needle.
+     * @details Searchers with preprocessing (e.g. std::boyer_moore_horspool_searcher, trl::ShiftOrSearcher or
+     * trl::Regex) are compiled on the first lookup of a needle, and reused by later lookups, until they are evicted.
+     * The cache is split into shards (selected by the hash of the needle), each with its own mutex and least recently
+     * used (LRU) eviction order, so concurrent lookups of different needles rarely contend. Searchers are compiled
+     * without holding a lock. The total number of searchers is kept in an atomic counter, and when a new searcher
+     * exceeds the capacity, the least recently used searchers of its own shard are evicted; only if that shard holds
+     * no other searchers, the least recently used searchers of the following shards are evicted. The eviction order is
+     * therefore LRU within each shard, but only approximately LRU across the cache. The hit, miss and eviction counts
+     * are kept in atomic counters.
+     *
+     * The cache owns a copy of each needle, and the searcher is created from it by the factory, so searchers holding
+     * iterators to the needle stay valid. Lookups return a std::shared_ptr, which keeps the searcher alive even if it
+     * is evicted while in use.
+     * #### Example
+     *   @code{.cpp}
+     *      using Searcher = std::boyer_moore_horspool_searcher<std::string::const_iterator>;
+     *      auto cache = trl::SearcherCache<Searcher>(256);
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all(str.begin(), str.end(), *cache.get("HELLO"), std::back_inserter(results));
+     *   @endcode
+     * @tparam Searcher The type of the searchers.
+     */
+    template<typename Searcher>
+    class SearcherCache
+    {
+    public:
+
+        /**
+         * @brief The function creating a searcher from a needle. The needle is owned by the cache, and outlives the
+         * searcher.
+         */
+        using Factory = std::function<Searcher(const std::string&)>;
+
+        /**
+         * @brief Constructor.
+         * @param capacity The maximum number of cached searchers. While new searchers are being added concurrently,
+         * the capacity may be exceeded by the number of concurrent insertions, until they return.
+         * @param shards The number of shards.
+         * @param factory The function creating a searcher from a needle. By default, the searcher is constructed
+         * from the begin and end iterators of the needle.
+         * @throws std::invalid_argument if capacity or shards is zero.
+         */
+        explicit SearcherCache(std::size_t capacity,
+                               std::size_t shards  = 16,
+                               Factory     factory = [](const std::string& needle) {
+                                   return Searcher(needle.begin(), needle.end());
+                               })
+            : m_shards(validShards(capacity, shards)),
+              m_capacity(capacity),
+              m_size(0),
+              m_factory(std::move(factory)),
+              m_hits(0),
+              m_misses(0),
+              m_evictions(0) {}
+
+        /**
+         * @brief Get the searcher for a needle, compiling it if it is not in the cache.
+         * @param needle The needle.
+         * @return A shared pointer to the searcher.
+         */
+        std::shared_ptr<const Searcher> get(const std::string& needle) {
+            const auto index = std::hash<std::string> {}(needle) % m_shards.size();
+            auto&      shard = m_shards[index];
+
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto                        found = shard.entries.find(needle);
+                if (found != shard.entries.end()) {
+                    shard.order.splice(shard.order.begin(), shard.order, found->second);
+                    m_hits.fetch_add(1, std::memory_order_relaxed);
+                    return searcherOf(*found->second);
+                }
+            }
+
+            // ===== Compile the searcher without holding the lock. If another thread added the needle in the
+            // ===== meantime, its searcher is used instead.
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            auto entry = std::make_shared<const Entry>(needle, m_factory);
+
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto                        found = shard.entries.find(needle);
+                if (found != shard.entries.end()) {
+                    shard.order.splice(shard.order.begin(), shard.order, found->second);
+                    return searcherOf(*found->second);
+                }
+
+                shard.order.push_front(entry);
+                shard.entries.emplace(needle, shard.order.begin());
+                m_size.fetch_add(1, std::memory_order_relaxed);
+                while (shard.order.size() > 1 && m_size.load(std::memory_order_relaxed) > m_capacity)
+                    evictOldest(shard);
+            }
+
+            // ===== If the shard holds only the new searcher, evict from the following shards, one lock at a time.
+            for (std::size_t i = 1; i < m_shards.size() && m_size.load(std::memory_order_relaxed) > m_capacity; ++i) {
+                auto&                       other = m_shards[(index + i) % m_shards.size()];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                while (!other.order.empty() && m_size.load(std::memory_order_relaxed) > m_capacity)
+                    evictOldest(other);
+            }
+            return searcherOf(entry);
+        }
+
+        /**
+         * @brief Get the hit, miss and eviction counts.
+         */
+        [[nodiscard]] SearcherCacheStatistics statistics() const {
+            return {m_hits.load(std::memory_order_relaxed),
+                    m_misses.load(std::memory_order_relaxed),
+                    m_evictions.load(std::memory_order_relaxed)};
+        }
+
+        /**
+         * @brief Get the number of cached searchers.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return m_size.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Remove all searchers from the cache. Searchers in use remain valid.
+         */
+        void clear() {
+            for (auto& shard : m_shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                m_size.fetch_sub(shard.order.size(), std::memory_order_relaxed);
+                shard.entries.clear();
+                shard.order.clear();
+            }
+        }
+
+    private:
+
+        /**
+         * @brief A cached searcher, with the needle it was created from.
+         */
+        struct Entry
+        {
+            Entry(const std::string& key, const Factory& factory) : needle(key), searcher(factory(needle)) {}
+
+            const std::string needle;   /**< The needle. */
+            const Searcher    searcher; /**< The searcher, referring to the needle. */
+        };
+
+        using EntryList = std::list<std::shared_ptr<const Entry>>;
+
+        /**
+         * @brief A shard of the cache: the entries in LRU order (most recently used first), and an index by needle.
+         */
+        struct Shard
+        {
+            mutable std::mutex                                            mutex   = {};
+            EntryList                                                     order   = {};
+            std::unordered_map<std::string, typename EntryList::iterator> entries = {};
+        };
+
+        static std::vector<Shard> validShards(std::size_t capacity, std::size_t shards) {
+            if (capacity == 0 || shards == 0)
+                throw std::invalid_argument("The SearcherCache capacity and number of shards must be positive.");
+            return std::vector<Shard>(std::min(shards, capacity));
+        }
+
+        /**
+         * @brief Evict the least recently used searcher of a shard. The mutex of the shard must be held.
+         */
+        void evictOldest(Shard& shard) {
+            shard.entries.erase(shard.order.back()->needle);
+            shard.order.pop_back();
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get a pointer to the searcher of an entry, sharing ownership of the entry.
+         */
+        static std::shared_ptr<const Searcher> searcherOf(const std::shared_ptr<const Entry>& entry) {
+            return std::shared_ptr<const Searcher>(entry, &entry->searcher);
+        }
+
+        std::vector<Shard>         m_shards;    /**< The shards. */
+        std::size_t                m_capacity;  /**< The maximum number of searchers. */
+        std::atomic<std::size_t>   m_size;      /**< The number of searchers in all shards. */
+        Factory                    m_factory;   /**< The function creating a searcher from a needle. */
+        std::atomic<std::uint64_t> m_hits;      /**< The number of lookups which found a cached searcher. */
+        std::atomic<std::uint64_t> m_misses;    /**< The number of lookups which compiled a searcher. */
+        std::atomic<std::uint64_t> m_evictions; /**< The number of evicted searchers. */
+    };
+
+    // ===== PATTERN SEARCH ALGORITHMS
+
+    namespace detail
+    {
+        /**
+         * @brief A segment of a glob pattern between two '*' wildcards, consisting of literal elements and '?'
+         * wildcards. The longest run of literal elements is used as the anchor, when searching for the segment.
+         */
+        template<typename PatternIt>
+        struct GlobSegment
+        {
+            PatternIt      first;        /**< The first element of the segment. */
+            PatternIt      last;         /**< One element beyond the last element of the segment. */
+            std::ptrdiff_t length;       /**< The number of elements in the segment. */
+            PatternIt      anchorFirst;  /**< The first element of the anchor. */
+            PatternIt      anchorLast;   /**< One element beyond the last element of the anchor. */
+            std::ptrdiff_t anchorOffset; /**< The offset of the anchor from the start of the segment. */
+        };
+
+        /**
+         * @brief Split a glob pattern into the segments between the '*' wildcards. Empty segments (i.e. leading,
+         * trailing and repeated '*' wildcards) are discarded, as they do not affect where a match starts.
+         */
+        template<typename PatternIt>
+        std::vector<GlobSegment<PatternIt>> parseGlob(PatternIt p_first, PatternIt p_last) {
+            std::vector<GlobSegment<PatternIt>> segments;
+            while (p_first != p_last) {
+                auto segmentLast = std::find(p_first, p_last, '*');
+                if (segmentLast != p_first) {
+                    GlobSegment<PatternIt> segment {p_first, segmentLast, std::distance(p_first, segmentLast),
+                                                    p_first, p_first, 0};
+
+                    // ===== Find the longest run of literal elements in the segment.
+                    for (auto runFirst = p_first; runFirst != segmentLast;) {
+                        auto runLast = std::find(runFirst, segmentLast, '?');
+                        if (std::distance(runFirst, runLast) > std::distance(segment.anchorFirst, segment.anchorLast)) {
+                            segment.anchorFirst  = runFirst;
+                            segment.anchorLast   = runLast;
+                            segment.anchorOffset = std::distance(p_first, runFirst);
+                        }
+                        runFirst = (runLast == segmentLast) ? runLast : std::next(runLast);
+                    }
+                    segments.push_back(segment);
+                }
+                p_first = (segmentLast == p_last) ? segmentLast : std::next(segmentLast);
+            }
+
+            return segments;
+        }
+
+        /**
+         * @brief Find the first occurrence of a glob segment in the range [first, last). The anchor of the segment is
+         * located using the (contiguous-aware) search, and the rest of the segment is verified around each candidate.
+         * @return An iterator to the start of the occurrence, or \c last if there is none.
+         */
+        template<typename BidirIt, typename PatternIt>
+        BidirIt findGlobSegment(BidirIt first, BidirIt last, const GlobSegment<PatternIt>& segment) {
+            if (std::distance(first, last) < segment.length)
+                return last;
+
+            // ===== Limit the anchor search, so that the whole segment fits in the range.
+            const auto anchorLength = std::distance(segment.anchorFirst, segment.anchorLast);
+            const auto searchLast   = std::prev(last, segment.length - segment.anchorOffset - anchorLength);
+            if (anchorLength == 0)
+                return first;
+
+            for (auto position = std::next(first, segment.anchorOffset);;) {
+                auto anchor = detail::search(position, searchLast, segment.anchorFirst, segment.anchorLast);
+                if (anchor == searchLast)
+                    return last;
+
+                auto candidate = std::prev(anchor, segment.anchorOffset);
+                auto it        = candidate;
+                auto p_it      = segment.first;
+                for (; p_it != segment.last && (*p_it == '?' || *it == *p_it); ++p_it, ++it) {}
+                if (p_it == segment.last)
+                    return candidate;
+
+                position = std::next(anchor);
+            }
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Search for all non-overlapping matches of a glob pattern in a container, in the range [first, last).
+     * @details In the pattern, '?' matches any single element, and '*' matches any sequence of elements (including an
+     * empty one, and including line breaks). All other elements match themselves; there is no escape character. The
+     * leftmost match is found first, and each '*' matches as few elements as possible. The search for the next match
+     * starts after the end of the previous one. A pattern without any elements other than '*' is never found.
+     *
+     * The pattern is split into segments at the '*' wildcards, and the segments are searched for in turn. Within each
+     * segment, the longest run of literal elements is located using the same kernels as trl::search_all (i.e. memchr
+     * and memcmp for contiguous sequences of bytes), and the '?' wildcards are only verified around these candidates.
+     * The running time is therefore close to that of trl::search_all.
+     * #### Example
+     * The following example will find the match "ERR: read timeout1" at position 0.
+     *   @code{.cpp}
+     *      auto str = std::string("ERR: read timeout1, ok");
+     *      auto pattern = std::string("ERR*timeout?");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all_glob(str.begin(), str.end(), pattern.begin(), pattern.end(), std::back_inserter(results));
+     *   @endcode
+     * @tparam BidirIt The type of the input iterator parameters. BidirIt will be auto-deducted by the compiler.
+     * @tparam ForwardIt The type of the pattern iterator parameters. ForwardIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param p_first The first element in the pattern.
+     * @param p_last One element beyond the last element in the pattern.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename BidirIt, typename ForwardIt, typename OutputIt>
+    OutputIt search_all_glob(BidirIt first,
+                             BidirIt last,
+                             ForwardIt p_first,
+                             ForwardIt p_last,
+                             OutputIt d_first) {
+        const auto segments = detail::parseGlob(p_first, p_last);
+        if (segments.empty())
+            return d_first;
+
+        while (first != last) {
+            auto start = detail::findGlobSegment(first, last, segments.front());
+            if (start == last)
+                break;
+
+            // ===== Find the following segments in turn. If one of them is not found, there can be no later matches.
+            auto end = std::next(start, segments.front().length);
+            for (auto segment = std::next(segments.begin()); segment != segments.end(); ++segment) {
+                auto found = detail::findGlobSegment(end, last, *segment);
+                if (found == last)
+                    return d_first;
+                end = std::next(found, segment->length);
+            }
+
+            *(d_first++) = start;
+            first = end;
+        }
+
+        return d_first;
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief A node in the syntax tree of a regular expression.
+         */
+        struct RegexNode
+        {
+            enum class Kind { Empty, Set, Concat, Alternate, Repeat };
+
+            Kind                   kind     = Kind::Empty; /**< The kind of node. */
+            CharClass              set      = {};          /**< For Set nodes, the bytes matched. */
+            std::vector<RegexNode> children = {};          /**< For Concat, Alternate and Repeat nodes, the operands. */
+            int                    min      = 0;           /**< For Repeat nodes, the minimum number of repetitions. */
+            int                    max      = 0;           /**< For Repeat nodes, the maximum number (-1 for no limit). */
+            int                    depth    = 1;           /**< The depth of the tree rooted at the node. */
+        };
+
+        /**
+         * @brief A recursive descent parser for the regular expressions supported by trl::Regex.
+         * @details The nesting of groups, and the depth of the syntax tree, are limited to maxDepth, as both the parser
+         * and the later passes over the tree are recursive; untrusted patterns can therefore not overflow the stack.
+         */
+        class RegexParser
+        {
+        public:
+            static constexpr int maxDepth = 1000; /**< The maximum nesting depth of groups and of the syntax tree. */
+
+            explicit RegexParser(const std::string& pattern) : m_pattern(pattern), m_position(0), m_groups(0) {}
+
+            /**
+             * @brief Parse the whole pattern.
+             * @throws std::invalid_argument if the pattern is not a valid regular expression.
+             */
+            RegexNode parse() {
+                auto node = parseAlternation();
+                if (m_position != m_pattern.size())
+                    fail("unbalanced ')'");
+                return node;
+            }
+
+        private:
+            [[noreturn]] void fail(const std::string& message) const {
+                throw std::invalid_argument("trl::Regex: " + message + " at position " + std::to_string(m_position) +
+                                            " in \"" + m_pattern + "\"");
+            }
+
+            bool atEnd() const { return m_position == m_pattern.size(); }
+            char peek() const { return m_pattern[m_position]; }
+            unsigned char next() { return static_cast<unsigned char>(m_pattern[m_position++]); }
+
+            RegexNode nest(RegexNode node) const {
+                node.depth = 0;
+                for (const auto& child : node.children)
+                    node.depth = std::max(node.depth, child.depth);
+                if (++node.depth > maxDepth)
+                    fail("pattern nested too deeply");
+                return node;
+            }
+
+            RegexNode parseAlternation() {
+                RegexNode node {RegexNode::Kind::Alternate};
+                node.children.push_back(parseConcatenation());
+                while (!atEnd() && peek() == '|') {
+                    ++m_position;
+                    node.children.push_back(parseConcatenation());
+                }
+                return node.children.size() == 1 ? std::move(node.children.front()) : nest(std::move(node));
+            }
+
+            RegexNode parseConcatenation() {
+                RegexNode node {RegexNode::Kind::Concat};
+                while (!atEnd() && peek() != '|' && peek() != ')')
+                    node.children.push_back(parseRepetition());
+                return node.children.size() == 1 ? std::move(node.children.front()) : nest(std::move(node));
+            }
+
+            RegexNode parseRepetition() {
+                auto node = parseAtom();
+                while (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) {
+                    RegexNode repeat {RegexNode::Kind::Repeat};
+                    switch (next()) {
+                        case '*': repeat.min = 0; repeat.max = -1; break;
+                        case '+': repeat.min = 1; repeat.max = -1; break;
+                        case '?': repeat.min = 0; repeat.max = 1; break;
+                        default:
+                            repeat.min = parseNumber();
+                            repeat.max = repeat.min;
+                            if (!atEnd() && peek() == ',') {
+                                ++m_position;
+                                repeat.max = (!atEnd() && peek() == '}') ? -1 : parseNumber();
+                            }
+                            if (atEnd() || next() != '}')
+                                fail("expected '}'");
+                            if (repeat.max != -1 && repeat.max < repeat.min)
+                                fail("invalid repetition bounds");
+                    }
+                    repeat.children.push_back(std::move(node));
+                    node = nest(std::move(repeat));
+                }
+                return node;
+            }
+
+            int parseNumber() {
+                int value = 0;
+                if (atEnd() || peek() < '0' || peek() > '9')
+                    fail("expected a number");
+                while (!atEnd() && peek() >= '0' && peek() <= '9') {
+                    value = value * 10 + (next() - '0');
+                    if (value > 1000)
+                        fail("repetition count too large");
+                }
+                return value;
+            }
+
+            RegexNode parseAtom() {
+                if (atEnd())
+                    fail("unexpected end of pattern");
+
+                RegexNode node {RegexNode::Kind::Set};
+                const auto c = next();
+                switch (c) {
+                    case '(':
+                        if (++m_groups > maxDepth)
+                            fail("groups nested too deeply");
+                        node = parseAlternation();
+                        if (atEnd() || next() != ')')
+                            fail("expected ')'");
+                        --m_groups;
+                        break;
+                    case '[': node.set = parseClass(); break;
+                    case '.': node.set = ~CharClass::of("\n"); break;
+                    case '\\': node.set = parseEscape(); break;
+                    case '*':
+                    case '+':
+                    case '?':
+                    case '{': fail("nothing to repeat");
+                    case '^':
+                    case '$': fail("anchors are not supported");
+                    default: node.set = CharClass::range(c, c);
+                }
+                return node;
+            }
+
+            CharClass parseEscape() {
+                if (atEnd())
+                    fail("incomplete escape sequence");
+
+                const auto c = next();
+                switch (c) {
+                    case 'd': return CharClass::digit();
+                    case 'D': return ~CharClass::digit();
+                    case 'w': return CharClass::alnum() | CharClass::of("_");
+                    case 'W': return ~(CharClass::alnum() | CharClass::of("_"));
+                    case 's': return CharClass::space();
+                    case 'S': return ~CharClass::space();
+                    case 'n': return CharClass::of("\n");
+                    case 'r': return CharClass::of("\r");
+                    case 't': return CharClass::of("\t");
+                    case 'f': return CharClass::of("\f");
+                    case 'v': return CharClass::of("\v");
+                    default:
+                        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                            fail("unsupported escape sequence");
+                        return CharClass::range(c, c);
+                }
+            }
+
+            CharClass parseClass() {
+                CharClass result;
+                const bool negate = !atEnd() && peek() == '^';
+                if (negate)
+                    ++m_position;
+
+                for (bool first = true; atEnd() || peek() != ']' || first; first = false) {
+                    if (atEnd())
+                        fail("expected ']'");
+
+                    auto c = next();
+                    if (c == '\\') {
+                        auto escaped = parseEscape();
+                        result = result | escaped;
+                        continue;
+                    }
+                    if (m_position + 1 < m_pattern.size() && peek() == '-' && m_pattern[m_position + 1] != ']') {
+                        ++m_position;
+                        auto last = next();
+                        if (last == '\\') {
+                            if (atEnd())
+                                fail("incomplete escape sequence");
+                            last = next();
+                        }
+                        if (last < c)
+                            fail("invalid range in character class");
+                        result = result | CharClass::range(c, last);
+                    }
+                    else
+                        result = result | CharClass::range(c, c);
+                }
+                ++m_position;
+
+                return negate ? ~result : result;
+            }
+
+            const std::string& m_pattern;  /**< The pattern being parsed. */
+            std::size_t        m_position; /**< The current position in the pattern. */
+            int                m_groups;   /**< The number of groups currently open. */
+        };
+
+        /**
+         * @brief Reverse a regular expression, so that it matches the reversed strings.
+         */
+        inline void reverseRegex(RegexNode& node) {
+            if (node.kind == RegexNode::Kind::Concat)
+                std::reverse(node.children.begin(), node.children.end());
+            for (auto& child : node.children)
+                reverseRegex(child);
+        }
+
+        /**
+         * @brief A state of a nondeterministic finite automaton: either a transition on a set of bytes to the next
+         * state, or epsilon transitions to any number of states.
+         */
+        struct NfaState
+        {
+            CharClass        set     = {}; /**< The bytes for which the transition is taken. */
+            int              next    = -1; /**< The target of the transition, or -1 if there is none. */
+            std::vector<int> epsilon = {}; /**< The targets of the epsilon transitions. */
+        };
+
+        /**
+         * @brief Build a nondeterministic finite automaton from a regular expression (Thompson's construction). State
+         * 0 is the accepting state. Bounded repetitions are expanded, so the number of states is limited.
+         */
+        class NfaBuilder
+        {
+        public:
+            explicit NfaBuilder(std::size_t max_states) : m_states(1), m_maxStates(max_states) {}
+
+            /**
+             * @brief Compile a node, given the state that follows it, and return the first state of the node.
+             */
+            int compile(const RegexNode& node, int out) {
+                switch (node.kind) {
+                    case RegexNode::Kind::Empty:
+                        return out;
+                    case RegexNode::Kind::Set:
+                        return add(NfaState {node.set, out, {}});
+                    case RegexNode::Kind::Concat:
+                        for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+                            out = compile(*child, out);
+                        return out;
+                    case RegexNode::Kind::Alternate: {
+                        std::vector<int> targets;
+                        for (const auto& child : node.children)
+                            targets.push_back(compile(child, out));
+                        return add(NfaState {{}, -1, targets});
+                    }
+                    case RegexNode::Kind::Repeat: {
+                        // ===== x{m,} is compiled as m copies of x, followed by x*; x{m,n} as m copies of x, followed
+                        // ===== by n - m nested optional copies.
+                        int result = out;
+                        if (node.max == -1) {
+                            result   = add(NfaState {});
+                            auto body = compile(node.children.front(), result);
+                            m_states[static_cast<std::size_t>(result)].epsilon = {body, out};
+                        }
+                        else
+                            for (int i = node.min; i < node.max; ++i)
+                                result = add(NfaState {{}, -1, {compile(node.children.front(), result), out}});
+
+                        for (int i = 0; i < node.min; ++i)
+                            result = compile(node.children.front(), result);
+                        return result;
+                    }
+                }
+                return out;
+            }
+
+            std::vector<NfaState>& states() { return m_states; }
+
+        private:
+            int add(NfaState state) {
+                if (m_states.size() >= m_maxStates)
+                    throw std::length_error("trl::Regex: the pattern is too large.");
+                m_states.push_back(std::move(state));
+                return static_cast<int>(m_states.size() - 1);
+            }
+
+            std::vector<NfaState> m_states;    /**< The states of the automaton. */
+            std::size_t           m_maxStates; /**< The maximum number of states. */
+        };
+
+        /**
+         * @brief A deterministic finite automaton over byte classes. State 0 is the dead state.
+         */
+        struct Dfa
+        {
+            std::vector<std::uint32_t> transitions = {}; /**< The next state, indexed by state * classes + class. */
+            std::vector<char>          accepting   = {}; /**< For each state, whether it is accepting. */
+            std::uint32_t              start       = 0;  /**< The start state. */
+            CharClass                  leavesStart = {}; /**< The bytes for which the start state is left. */
+        };
+
+        /**
+         * @brief Build a deterministic finite automaton from a nondeterministic one (subset construction).
+         * @param nfa The states of the nondeterministic automaton. State 0 is the accepting state.
+         * @param nfaStart The start state of the nondeterministic automaton.
+         * @param unanchored If true, a match may start at any position, i.e. the start state is included in every state.
+         * @param classes The byte class of each byte value.
+         * @param classCount The number of byte classes.
+         * @param max_states The maximum number of states.
+         * @throws std::length_error if the automaton has more than max_states states.
+         */
+        inline Dfa buildDfa(const std::vector<NfaState>& nfa,
+                            int                          nfaStart,
+                            bool                         unanchored,
+                            const unsigned char (&classes)[256],
+                            std::size_t                  classCount,
+                            std::size_t                  max_states) {
+            // ===== The epsilon closure of a set of states, as a sorted vector.
+            auto closure = [&](std::vector<int> states) {
+                std::vector<char> visited(nfa.size(), 0);
+                std::vector<int>  result;
+                while (!states.empty()) {
+                    const auto state = states.back();
+                    states.pop_back();
+                    if (visited[static_cast<std::size_t>(state)])
+                        continue;
+                    visited[static_cast<std::size_t>(state)] = 1;
+                    result.push_back(state);
+                    const auto& epsilon = nfa[static_cast<std::size_t>(state)].epsilon;
+                    states.insert(states.end(), epsilon.begin(), epsilon.end());
+                }
+                std::sort(result.begin(), result.end());
+                return result;
+            };
+
+            unsigned char representatives[256] = {};
+            for (unsigned value = 256; value-- > 0;)
+                representatives[classes[value]] = static_cast<unsigned char>(value);
+
+            Dfa                                     dfa;
+            std::vector<std::vector<int>>           subsets {{}};
+            std::map<std::vector<int>, std::uint32_t> ids {{{}, 0}};
+            const auto                              startSet = closure({nfaStart});
+
+            auto lookup = [&](const std::vector<int>& subset) {
+                auto found = ids.find(subset);
+                if (found != ids.end())
+                    return found->second;
+                if (subsets.size() >= max_states)
+                    throw std::length_error("trl::Regex: the automaton exceeds the maximum number of states.");
+                ids.emplace(subset, static_cast<std::uint32_t>(subsets.size()));
+                subsets.push_back(subset);
+                return static_cast<std::uint32_t>(subsets.size() - 1);
+            };
+
+            dfa.start = lookup(startSet);
+            for (std::size_t id = 0; id < subsets.size(); ++id) {
+                dfa.accepting.push_back(std::binary_search(subsets[id].begin(), subsets[id].end(), 0) ? 1 : 0);
+                for (std::size_t c = 0; c < classCount; ++c) {
+                    std::vector<int> moved;
+                    if (id != 0) {
+                        for (auto state : subsets[id]) {
+                            const auto& nfaState = nfa[static_cast<std::size_t>(state)];
+                            if (nfaState.next != -1 && nfaState.set.contains(representatives[c]))
+                                moved.push_back(nfaState.next);
+                        }
+                        if (unanchored)
+                            moved.insert(moved.end(), startSet.begin(), startSet.end());
+                    }
+                    dfa.transitions.push_back(moved.empty() ? 0 : lookup(closure(moved)));
+                }
+            }
+
+            for (unsigned value = 0; value < 256; ++value)
+                if (dfa.transitions[dfa.start * classCount + classes[value]] != dfa.start)
+                    dfa.leavesStart = dfa.leavesStart | CharClass::range(static_cast<unsigned char>(value),
+                                                                         static_cast<unsigned char>(value));
+
+            return dfa;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief A compiled regular expression, for use with trl::search_all_regex.
+     * @details The supported syntax is a subset of the POSIX extended / ECMAScript syntax, operating on bytes:
+     * - Literal bytes, and '\' followed by a punctuation character to match it literally.
+     * - '.' (any byte except '\n'), and the escapes \d, \w, \s (and their negations \D, \W, \S), \n, \r, \t, \f, \v.
+     * - Character classes such as [abc], [a-z0-9_] and [^,\n].
+     * - Grouping with ( and ), and alternation with |.
+     * - The repetitions *, +, ?, {m}, {m,} and {m,n} (with counts up to 1000).
+     *
+     * Groups may be nested up to 1000 levels deep, and so may the operators of the pattern (e.g. "a?????" nests five
+     * repetitions); deeper patterns are rejected with std::invalid_argument.
+     *
+     * Anchors, backreferences and lookaround are not supported. The pattern is compiled to a table-driven
+     * deterministic automaton (DFA), so there is no backtracking: each step of the automaton takes constant time,
+     * and trl::search_all_regex enters each state at most once per byte, so its running time is linear in the length
+     * of the range (times the number of states, in the worst case). As the number of DFA states can grow exponentially with the size of the pattern, it is capped,
+     * and std::length_error is thrown if the cap is exceeded. The transition tables are indexed by byte classes (sets
+     * of bytes which are treated identically by the pattern), to keep them small.
+     * #### Example
+     *   @code{.cpp}
+     *      auto regex = trl::Regex("(ERROR|WARN)[0-9]{3,4}");
+     *   @endcode
+     */
+    class Regex
+    {
+    public:
+
+        /**
+         * @brief Constructor, compiling the pattern.
+         * @param pattern The regular expression.
+         * @param max_states The maximum number of states in each automaton. Each state takes four bytes per byte class.
+         * @throws std::invalid_argument if the pattern is not a valid regular expression.
+         * @throws std::length_error if the pattern or the automaton exceeds the maximum number of states.
+         */
+        explicit Regex(const std::string& pattern, std::size_t max_states = 10000)
+            : m_classCount(1),
+              m_forward(),
+              m_reverse(),
+              m_literal() {
+
+            auto tree = detail::RegexParser(pattern).parse();
+            detectLiteral(tree);
+
+            // ===== Partition the bytes into classes, which are treated identically by all sets in the pattern.
+            detail::NfaBuilder forwardBuilder(max_states * 16);
+            const auto         forwardStart = forwardBuilder.compile(tree, 0);
+            std::vector<CharClass> sets;
+            std::set<std::string>  unique;
+            for (const auto& state : forwardBuilder.states())
+                if (state.next != -1 && unique.emplace(reinterpret_cast<const char*>(state.set.table()), 32).second)
+                    sets.push_back(state.set);
+
+            for (const auto& set : sets) {
+                std::map<std::pair<unsigned char, bool>, unsigned char> refined;
+                for (unsigned value = 0; value < 256; ++value) {
+                    const auto key = std::make_pair(m_classes[value], set.contains(static_cast<unsigned char>(value)));
+                    auto found = refined.find(key);
+                    if (found == refined.end())
+                        found = refined.emplace(key, static_cast<unsigned char>(refined.size())).first;
+                    m_classes[value] = found->second;
+                }
+                m_classCount = refined.size();
+            }
+
+            m_forward = detail::buildDfa(forwardBuilder.states(), forwardStart, false, m_classes, m_classCount, max_states);
+
+            detail::reverseRegex(tree);
+            detail::NfaBuilder reverseBuilder(max_states * 16);
+            const auto         reverseStart = reverseBuilder.compile(tree, 0);
+            m_reverse = detail::buildDfa(reverseBuilder.states(), reverseStart, true, m_classes, m_classCount, max_states);
+        }
+
+        /**
+         * @brief Find the longest non-empty match starting at first.
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @return An iterator to one beyond the end of the longest match, or \c first if there is no non-empty match.
+         */
+        template<typename InputIt>
+        InputIt match(InputIt first, InputIt last) const {
+            auto end   = first;
+            auto state = m_forward.start;
+            for (auto it = first; it != last;) {
+                state = m_forward.transitions[state * m_classCount + m_classes[detail::narrow<unsigned char>(*it)]];
+                if (state == 0)
+                    break;
+                ++it;
+                if (m_forward.accepting[state])
+                    end = it;
+            }
+            return end;
+        }
+
+        /**
+         * @brief Find the longest non-empty match starting at first, as match(), for successive calls with increasing
+         * first over the same range, as made by trl::search_all_regex.
+         * @details The states of the automaton beyond the end of the match are recorded in visited, by offset from
+         * origin. A later call which reaches a recorded state at the same offset stops there, as the earlier call has
+         * already established that no match ends further on. Each state is therefore entered at most once per
+         * position over all calls, rather than the range being rescanned from every match start.
+         * @param origin The iterator from which offsets are measured.
+         * @param first The first element in the range to examine.
+         * @param last One element beyond the last element in the range to examine.
+         * @param visited The states recorded by earlier calls, as pairs of offset and state.
+         * @return An iterator to one beyond the end of the longest match, or \c first if there is no non-empty match.
+         */
+        template<typename RandomIt>
+        RandomIt match(RandomIt                                          origin,
+                       RandomIt                                          first,
+                       RandomIt                                          last,
+                       std::set<std::pair<std::size_t, std::uint32_t>>& visited) const {
+            const auto horizon = visited.empty() ? 0 : visited.rbegin()->first;
+
+            std::vector<std::pair<std::size_t, std::uint32_t>> tail;
+            auto end   = first;
+            auto state = m_forward.start;
+            for (auto it = first; it != last;) {
+                state = m_forward.transitions[state * m_classCount + m_classes[detail::narrow<unsigned char>(*it)]];
+                if (state == 0)
+                    break;
+                ++it;
+                if (m_forward.accepting[state]) {
+                    end = it;
+                    tail.clear();
+                }
+
+                const auto offset = static_cast<std::size_t>(it - origin);
+                if (offset <= horizon && visited.count({offset, state}) != 0)
+                    break;
+                tail.emplace_back(offset, state);
+            }
+
+            visited.insert(tail.begin(), tail.end());
+            return end;
+        }
+
+        /**
+         * @brief Find the positions where a match starts, in the range [first, last), by running the automaton for
+         * the reversed pattern backwards from last. Bit i of the result is set if a match starts at first + i.
+         */
+        template<typename BidirIt>
+        std::vector<std::uint64_t> matchStarts(BidirIt first, BidirIt last) const {
+            const auto                 length = static_cast<std::size_t>(std::distance(first, last));
+            std::vector<std::uint64_t> starts((length + 63) / 64, 0);
+
+            auto state    = m_reverse.start;
+            auto position = length;
+            for (auto it = last; it != first;) {
+                // ===== While in the start state, skip directly to the previous byte which leaves it.
+                if constexpr (std::is_pointer<BidirIt>::value) {
+                    if (state == m_reverse.start && !m_reverse.accepting[state]) {
+                        const auto* bytes = detail::asBytes(first);
+                        const auto* found = detail::findLastClassByte(bytes, bytes + position, m_reverse.leavesStart);
+                        if (found == bytes + position)
+                            break;
+                        position = static_cast<std::size_t>(found - bytes) + 1;
+                        it       = first + position;
+                    }
+                }
+
+                --it;
+                --position;
+                state = m_reverse.transitions[state * m_classCount + m_classes[detail::narrow<unsigned char>(*it)]];
+                if (m_reverse.accepting[state])
+                    starts[position / 64] |= std::uint64_t(1) << (position % 64);
+            }
+
+            return starts;
+        }
+
+        /**
+         * @brief If the pattern is a plain string of bytes, return it; otherwise, return an empty string.
+         */
+        [[nodiscard]] const std::string& literal() const {
+            return m_literal;
+        }
+
+    private:
+
+        /**
+         * @brief Determine if the pattern is a plain string, i.e. a sequence of sets of one byte each.
+         */
+        void detectLiteral(const detail::RegexNode& tree) {
+            std::vector<const detail::RegexNode*> nodes;
+            if (tree.kind == detail::RegexNode::Kind::Concat)
+                for (const auto& child : tree.children)
+                    nodes.push_back(&child);
+            else
+                nodes.push_back(&tree);
+
+            std::string literal;
+            for (const auto* node : nodes) {
+                if (node->kind != detail::RegexNode::Kind::Set)
+                    return;
+                int count = 0;
+                unsigned char member = 0;
+                for (unsigned value = 0; value < 256; ++value)
+                    if (node->set.contains(static_cast<unsigned char>(value))) {
+                        ++count;
+                        member = static_cast<unsigned char>(value);
+                    }
+                if (count != 1)
+                    return;
+                literal += static_cast<char>(member);
+            }
+            m_literal = literal;
+        }
+
+        unsigned char m_classes[256] = {}; /**< The byte class of each byte value. */
+        std::size_t   m_classCount;        /**< The number of byte classes. */
+        detail::Dfa   m_forward;           /**< The anchored automaton for the pattern. */
+        detail::Dfa   m_reverse;           /**< The unanchored automaton for the reversed pattern. */
+        std::string   m_literal;           /**< The pattern, if it is a plain string of bytes. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Implementation of trl::search_all_regex, for the range [first, last), where iterators to the results
+         * are offsets from origin.
+         */
+        template<typename RandomIt, typename Iter, typename OutputIt>
+        OutputIt searchRegex(RandomIt origin, Iter first, Iter last, const Regex& regex, OutputIt d_first) {
+            const auto starts = regex.matchStarts(first, last);
+            const auto length = static_cast<std::size_t>(last - first);
+
+            std::set<std::pair<std::size_t, std::uint32_t>> visited;
+            for (std::size_t position = 0; position < length;) {
+                // ===== Find the next position where a match starts.
+                auto word = position / 64;
+                auto bits = starts[word] & (~std::uint64_t(0) << (position % 64));
+                while (bits == 0 && ++word < starts.size())
+                    bits = starts[word];
+                if (bits == 0)
+                    break;
+                position = word * 64 + static_cast<std::size_t>(countTrailingZeros(bits));
+
+                const auto start = first + static_cast<typename std::iterator_traits<Iter>::difference_type>(position);
+                const auto match = regex.match(first, start, last, visited);
+                if (match == start)
+                    ++position;
+                else {
+                    *(d_first++) = origin + (start - first);
+                    position     = static_cast<std::size_t>(match - first);
+                }
+
+                // ===== States recorded before the next match start can not be reached again.
+                visited.erase(visited.begin(), visited.lower_bound({position, 0}));
+            }
+
+            return d_first;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Search for all non-overlapping matches of a regular expression in a container, in the range [first, last).
+     * @details The matches are leftmost-longest: the match starting first is found, and of the matches starting
+     * there, the longest one is used. The search for the next match starts after the end of the previous one.
+     * Empty matches are not reported. Iterators to the start of the matches are written to the output, as for
+     * trl::search_all; the end of a match can be found with Regex::match.
+     *
+     * The positions where a match starts are found in a single backwards pass over the range, with the automaton for
+     * the reversed pattern; bytes that can not end a match are skipped using vectorized character class scans. From
+     * each match start, the longest match is then found with the automaton for the pattern. Where that automaton runs
+     * on beyond the end of a match, its states are recorded, and the scan for a later match stops when it reaches a
+     * recorded state at the same position; hence the range is not rescanned from every match start (as it would be
+     * for e.g. "a+b|a" on a run of a's), and no state is entered twice at the same position. If the pattern is a
+     * plain string, the search is delegated to the kernels used by trl::search_all. As matches are reported in a
+     * single pass, one bit of memory is used per element in the range, plus the states recorded beyond the end of
+     * the last match.
+     * #### Example
+     * The following example will find the matches "ERROR404" and "WARN1234" at positions 0 and 9.
+     *   @code{.cpp}
+     *      auto str = std::string("ERROR404 WARN1234 INFO1");
+     *      std::vector<decltype(str.begin())> results;
+     *      trl::search_all_regex(str.begin(), str.end(), trl::Regex("(ERROR|WARN)[0-9]{3,4}"), std::back_inserter(results));
+     *   @endcode
+     * @tparam RandomIt The type of the input iterator parameters. The value_type must be a byte-sized integral type,
+     * e.g. char or unsigned char. RandomIt will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param regex The compiled regular expression.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search_all_regex(RandomIt first,
+                              RandomIt last,
+                              const Regex& regex,
+                              OutputIt d_first) {
+        static_assert(detail::IsByteComparable<typename std::iterator_traits<RandomIt>::value_type>::value,
+                      "Regular expressions can only be matched against sequences of bytes!");
+        static_assert(IsRandomAccessIterator<RandomIt>::value, "Input container is not sequential!");
+
+        if (first == last)
+            return d_first;
+
+        if constexpr (IsContiguousIterator<RandomIt>::value) {
+            const auto* bytes  = detail::asBytes(std::addressof(*first));
+            const auto* end    = bytes + (last - first);
+            const auto& string = regex.literal();
+
+            // ===== Plain strings are searched for using memchr/memcmp.
+            if (!string.empty()) {
+                const auto* s_first = detail::asBytes(string.data());
+                const auto* s_last  = s_first + string.size();
+                for (const auto* it = bytes; (it = detail::searchBytes(it, end, s_first, s_last)) != end; it += string.size())
+                    *(d_first++) = first + (it - bytes);
+                return d_first;
+            }
+
+            return detail::searchRegex(first, bytes, end, regex, d_first);
+        }
+        else
+            return detail::searchRegex(first, first, last, regex, d_first);
+    }
+
+    // ===== APPROXIMATE SEARCH ALGORITHMS
+
+    /**
+     * @brief The result of an approximate search: the end of a match, and the distance between the match and the
+     * searched sequence.
+     * @tparam Iter The type of the iterators of the searched range.
+     */
+    template<typename Iter>
+    struct ApproximateMatch
+    {
+        Iter        last;     /**< One element beyond the last element of the match. */
+        std::size_t distance; /**< The number of edits (or mismatches) in the match. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Determine if two element types can be matched using the bit-parallel kernels, i.e. if both are
+         * bytes of the same signedness, so that equal values have equal byte representations.
+         */
+        template<typename T, typename U>
+        using IsBitParallelMatchable = std::conjunction<IsByteComparable<T>,
+                                                        IsByteComparable<U>,
+                                                        std::bool_constant<std::is_signed<T>::value == std::is_signed<U>::value>>;
+
+        /**
+         * @brief Build the match table for the bit-parallel kernels: for each byte value, a bitmask with bit i set if
+         * element i of the sequence equals the byte.
+         */
+        template<typename ForwardIt>
+        void buildMatchMasks(ForwardIt s_first, ForwardIt s_last, std::uint64_t (&masks)[256]) {
+            std::fill(std::begin(masks), std::end(masks), std::uint64_t(0));
+            for (std::uint64_t bit = 1; s_first != s_last; ++s_first, bit <<= 1)
+                masks[narrow<unsigned char>(*s_first)] |= bit;
+        }
+
+        /**
+         * @brief Find all end positions of approximate matches with an edit distance of at most max_distance, using
+         * Myers' bit-vector algorithm. The sequence must have between 1 and 64 elements.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+        OutputIt searchApproxMyers(ForwardIt1 first,
+                                   ForwardIt1 last,
+                                   ForwardIt2 s_first,
+                                   ForwardIt2 s_last,
+                                   OutputIt d_first,
+                                   std::size_t max_distance) {
+            std::uint64_t masks[256];
+            buildMatchMasks(s_first, s_last, masks);
+
+            const auto          length  = static_cast<std::size_t>(std::distance(s_first, s_last));
+            const std::uint64_t highBit = std::uint64_t(1) << (length - 1);
+            std::uint64_t       pv      = ~std::uint64_t(0);
+            std::uint64_t       mv      = 0;
+            std::size_t         score   = length;
+
+            while (first != last) {
+                const std::uint64_t eq = masks[narrow<unsigned char>(*first)];
+                const std::uint64_t xv = eq | mv;
+                const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                std::uint64_t       ph = mv | ~(xh | pv);
+                std::uint64_t       mh = pv & xh;
+
+                if (ph & highBit)
+                    ++score;
+                else if (mh & highBit)
+                    --score;
+
+                // ===== The horizontal deltas are not or'ed with 1, as a match may start anywhere in the text.
+                ph <<= 1;
+                mh <<= 1;
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
+
+                ++first;
+                if (score <= max_distance)
+                    *(d_first++) = ApproximateMatch<ForwardIt1> {first, score};
+            }
+
+            return d_first;
+        }
+
+        /**
+         * @brief Find all end positions of approximate matches with an edit distance of at most max_distance, using
+         * the dynamic programming algorithm by Sellers, with a single column of the distance matrix.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+        OutputIt searchApproxDynamic(ForwardIt1 first,
+                                     ForwardIt1 last,
+                                     ForwardIt2 s_first,
+                                     ForwardIt2 s_last,
+                                     OutputIt d_first,
+                                     std::size_t max_distance) {
+            const auto               length = static_cast<std::size_t>(std::distance(s_first, s_last));
+            std::vector<std::size_t> column(length + 1);
+            for (std::size_t i = 0; i <= length; ++i)
+                column[i] = i;
+
+            while (first != last) {
+                std::size_t diagonal = 0; // The value of column[i - 1] from the previous column; row 0 is always 0.
+                auto        s_it     = s_first;
+                for (std::size_t i = 1; i <= length; ++i, ++s_it) {
+                    const std::size_t previous = column[i];
+                    column[i] = std::min({previous + 1, column[i - 1] + 1, diagonal + (*s_it == *first ? 0 : 1)});
+                    diagonal  = previous;
+                }
+
+                ++first;
+                if (column[length] <= max_distance)
+                    *(d_first++) = ApproximateMatch<ForwardIt1> {first, column[length]};
+            }
+
+            return d_first;
+        }
+
+        /**
+         * @brief Find all end positions of matches with at most max_mismatches mismatches, using the bit-parallel
+         * Shift-And algorithm extended by Wu and Manber, with one state word per number of mismatches. The sequence
+         * must have between 1 and 64 elements.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+        OutputIt searchMismatchBitParallel(ForwardIt1 first,
+                                           ForwardIt1 last,
+                                           ForwardIt2 s_first,
+                                           ForwardIt2 s_last,
+                                           OutputIt d_first,
+                                           std::size_t max_mismatches) {
+            std::uint64_t masks[256];
+            buildMatchMasks(s_first, s_last, masks);
+
+            const auto                 length  = static_cast<std::size_t>(std::distance(s_first, s_last));
+            const std::uint64_t        highBit = std::uint64_t(1) << (length - 1);
+            std::vector<std::uint64_t> states(std::min(max_mismatches, length) + 1, 0);
+
+            while (first != last) {
+                // ===== Bit i of states[d] is set if the last i + 1 elements match the first i + 1 elements of the
+                // ===== sequence with d mismatches or less.
+                const std::uint64_t eq       = masks[narrow<unsigned char>(*first)];
+                std::uint64_t       previous = states[0];
+                states[0]                    = ((states[0] << 1) | 1) & eq;
+                for (std::size_t d = 1; d < states.size(); ++d) {
+                    const std::uint64_t current = states[d];
+                    states[d]                   = (((current << 1) | 1) & eq) | ((previous << 1) | 1);
+                    previous                    = current;
+                }
+
+                ++first;
+                for (std::size_t d = 0; d < states.size(); ++d)
+                    if (states[d] & highBit) {
+                        *(d_first++) = ApproximateMatch<ForwardIt1> {first, d};
+                        break;
+                    }
+            }
+
+            return d_first;
+        }
+
+        /**
+         * @brief Find all end positions of matches with at most max_mismatches mismatches, by comparing each window
+         * of the text with the sequence.
+         */
+        template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+        OutputIt searchMismatchWindowed(ForwardIt1 first,
+                                        ForwardIt1 last,
+                                        ForwardIt2 s_first,
+                                        ForwardIt2 s_last,
+                                        OutputIt d_first,
+                                        std::size_t max_mismatches) {
+            const auto length = std::distance(s_first, s_last);
+            auto       window = first;
+            for (auto count = std::distance(first, last); count >= length; --count, ++window) {
+                std::size_t mismatches = 0;
+                auto        it         = window;
+                for (auto s_it = s_first; s_it != s_last && mismatches <= max_mismatches; ++s_it, ++it)
+                    if (!(*it == *s_it))
+                        ++mismatches;
+
+                if (mismatches <= max_mismatches)
+                    *(d_first++) = ApproximateMatch<ForwardIt1> {std::next(window, length), mismatches};
+            }
+
+            return d_first;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Search for all approximate occurrences of a sequence of values in a container, in the range [first, last),
+     * allowing up to max_distance edits (insertions, deletions and substitutions).
+     * @details For each position in the range where an approximate match ends, a trl::ApproximateMatch is written to
+     * the output, holding an iterator one beyond the end of the match, and the smallest edit distance of any match
+     * ending there. Hence, a match with few edits is typically surrounded by matches with more edits, ending at the
+     * neighbouring positions.
+     *
+     * For sequences of up to 64 bytes (e.g. std::string), Myers' bit-vector algorithm is used, which processes each
+     * element of the range in a constant number of word operations. Otherwise, the edit distance matrix is computed
+     * column by column, which takes time proportional to the length of the sequence for each element.
+     * An empty sequence is never found.
+     * #### Example
+     * The following example will find "color", "colour" and "kolor", ending at the positions 5, 12 and 18 with the
+     * distances 0, 1 and 1, respectively (and a few neighbouring positions with larger distances).
+     *   @code{.cpp}
+     *      auto str = std::string("color colour kolor");
+     *      auto src = std::string("color");
+     *      std::vector<trl::ApproximateMatch<decltype(str.begin())>> results;
+     *      trl::search_all_approx(str.begin(), str.end(), src.begin(), src.end(), std::back_inserter(results), 1);
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param max_distance The maximum number of edits.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    OutputIt search_all_approx(ForwardIt1 first,
+                               ForwardIt1 last,
+                               ForwardIt2 s_first,
+                               ForwardIt2 s_last,
+                               OutputIt d_first,
+                               std::size_t max_distance) {
+        using ValueType    = typename std::iterator_traits<ForwardIt1>::value_type;
+        using SeqValueType = typename std::iterator_traits<ForwardIt2>::value_type;
+
+        const auto length = std::distance(s_first, s_last);
+        if (length == 0)
+            return d_first;
+
+        if constexpr (detail::IsBitParallelMatchable<ValueType, SeqValueType>::value)
+            if (length <= 64)
+                return detail::searchApproxMyers(first, last, s_first, s_last, d_first, max_distance);
+
+        return detail::searchApproxDynamic(first, last, s_first, s_last, d_first, max_distance);
+    }
+
+    /**
+     * @brief Search for all occurrences of a sequence of values in a container, in the range [first, last), allowing
+     * up to max_mismatches mismatching elements (i.e. a Hamming distance of at most max_mismatches).
+     * @details For each position in the range where a match ends, a trl::ApproximateMatch is written to the output,
+     * holding an iterator one beyond the end of the match, and the number of mismatches. The matches may overlap.
+     *
+     * For sequences of up to 64 bytes (e.g. std::string), the bit-parallel Shift-And algorithm (extended by Wu and
+     * Manber) is used, which processes each element of the range in a number of word operations proportional to
+     * max_mismatches. Otherwise, each window of the range is compared with the sequence. An empty sequence is never found.
+     * #### Example
+     * The following example will find "TAG-7" and "TAG-1" (with one mismatch), and "TAB-7" (with one mismatch).
+     *   @code{.cpp}
+     *      auto str = std::string("TAG-7 TAG-1 TAB-7");
+     *      auto src = std::string("TAG-7");
+     *      std::vector<trl::ApproximateMatch<decltype(str.begin())>> results;
+     *      trl::search_all_mismatch(str.begin(), str.end(), src.begin(), src.end(), std::back_inserter(results), 1);
+     *   @endcode
+     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
+     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
+     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @param s_first The first element in the search range.
+     * @param s_last The last element in the search range.
+     * @param d_first An output iterator pointing to the first element to fill in the output container.
+     * @param max_mismatches The maximum number of mismatching elements.
+     * @return An output iterator pointing to one element beyond the last element of the output container.
+     */
+    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
+    OutputIt search_all_mismatch(ForwardIt1 first,
+                                 ForwardIt1 last,
+                                 ForwardIt2 s_first,
+                                 ForwardIt2 s_last,
+                                 OutputIt d_first,
+                                 std::size_t max_mismatches) {
+        using ValueType    = typename std::iterator_traits<ForwardIt1>::value_type;
+        using SeqValueType = typename std::iterator_traits<ForwardIt2>::value_type;
+
+        const auto length = std::distance(s_first, s_last);
+        if (length == 0)
+            return d_first;
+
+        if constexpr (detail::IsBitParallelMatchable<ValueType, SeqValueType>::value)
+            if (length <= 64)
+                return detail::searchMismatchBitParallel(first, last, s_first, s_last, d_first, max_mismatches);
+
+        return detail::searchMismatchWindowed(first, last, s_first, s_last, d_first, max_mismatches);
+    }
+
+    // ===== UNICODE ALGORITHMS
+
+    /**
+     * @brief Finds the first invalid UTF-8 sequence in the range [first, last) of a container of bytes.
+     * @details Overlong encodings, surrogates (U+D800 to U+DFFF), code points above U+10FFFF and truncated sequences
+     * are considered invalid. For contiguous sequences, runs of ASCII characters are skipped 16 bytes at a time.
+     * #### Example
+     * The following example will find the truncated sequence at index 2.
+     *   @code{.cpp}
+     *      auto str = std::string("ab\xC3");
+     *      auto invalid = trl::find_invalid_utf8(str.begin(), str.end());
+     *   @endcode
+     * @tparam InputIt The type of the input iterator parameters. The value_type must be a byte-sized integral type,
+     * e.g. char or unsigned char. InputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @return An iterator pointing to the first byte of the first invalid sequence; if the range is valid UTF-8,
+     * \c last will be returned.
+     */
+    template<typename InputIt>
+    InputIt find_invalid_utf8(InputIt first, InputIt last) {
+        static_assert(detail::IsByteComparable<typename std::iterator_traits<InputIt>::value_type>::value,
+                      "UTF-8 validation requires a sequence of bytes!");
+
+        return detail::lowerToPointers(first, last, [](auto f, auto l) { return detail::findInvalidUtf8Kernel(f, l); });
+    }
+
+    /**
+     * @brief Determine if the range [first, last) of a container of bytes is valid UTF-8.
+     * @tparam InputIt The type of the input iterator parameters. InputIt will be auto-deducted by the compiler.
+     * @param first The first element in the range to examine.
+     * @param last One element beyond the last element in the range to examine.
+     * @return true if the range is valid UTF-8; otherwise false.
+     */
+    template<typename InputIt>
+    bool is_valid_utf8(InputIt first, InputIt last) {
+        return find_invalid_utf8(first, last) == last;
+    }
+
+    // ===== INDEXING ALGORITHMS
+
+    namespace detail
+    {
+        /**
+         * @brief Construct the suffix array of the string s of length n, with values in the range [0, upper], using
+         * the SA-IS algorithm (induced sorting) in linear time. The suffixes of the reduced string of LMS substrings
+         * are sorted recursively.
+         * @details Apart from the result, only a bit per element and an array of upper + 1 bucket positions are kept.
+         * The names of the LMS substrings are stored in the upper half of the result, and the result is released
+         * while the reduced string is sorted, so the peak memory is about sizeof(IndexType) * (n + m) bytes, where
+         * m <= n / 2 is the number of LMS substrings.
+         * @tparam IndexType The unsigned integral type used for positions. Its maximum value is used as a marker, so
+         * n must be less than it.
+         */
+        template<typename IndexType, typename Value>
+        std::vector<IndexType> suffixArray(const Value* s, IndexType n, IndexType upper) {
+            constexpr auto empty = std::numeric_limits<IndexType>::max();
+
+            if (n == 0)
+                return {};
+            if (n == 1)
+                return {0};
+            if (n == 2)
+                return s[0] < s[1] ? std::vector<IndexType> {0, 1} : std::vector<IndexType> {1, 0};
+
+            // ===== Classify the suffixes as S-type (smaller than the next suffix) or L-type.
+            const auto        size = std::size_t(n);
+            std::vector<bool> isS(size);
+            for (auto i = size - 1; i-- > 0;)
+                isS[i] = (s[i] == s[i + 1]) ? isS[i + 1] : (s[i] < s[i + 1]);
+            auto isLms = [&](std::size_t i) { return i > 0 && isS[i] && !isS[i - 1]; };
+
+            // ===== The start or the end of the bucket of each value, recounted when needed rather than kept in two
+            // ===== arrays, as the number of values is up to n / 2 in the recursion.
+            std::vector<IndexType> bucket(std::size_t(upper) + 1);
+            auto bucketBounds = [&](bool ends) {
+                std::fill(bucket.begin(), bucket.end(), IndexType(0));
+                for (std::size_t i = 0; i < size; ++i)
+                    ++bucket[s[i]];
+                IndexType total = 0;
+                for (auto& bound : bucket) {
+                    total = static_cast<IndexType>(total + bound);
+                    bound = ends ? total : static_cast<IndexType>(total - bound);
+                }
+            };
+
+            // ===== Sort all suffixes by inducing from the LMS suffixes, placed at the ends of their buckets by
+            // ===== placeLms (in sorted order, if known).
+            std::vector<IndexType> sa(size);
+            auto induce = [&](auto placeLms) {
+                std::fill(sa.begin(), sa.end(), empty);
+                bucketBounds(true);
+                placeLms();
+
+                bucketBounds(false);
+                sa[bucket[s[size - 1]]++] = static_cast<IndexType>(size - 1);
+                for (std::size_t i = 0; i < size; ++i) {
+                    const auto position = sa[i];
+                    if (position != empty && position >= 1 && !isS[position - 1u])
+                        sa[bucket[s[position - 1u]]++] = static_cast<IndexType>(position - 1u);
+                }
+
+                bucketBounds(true);
+                for (auto i = size; i-- > 0;) {
+                    const auto position = sa[i];
+                    if (position != empty && position >= 1 && isS[position - 1u])
+                        sa[--bucket[s[position - 1u]]] = static_cast<IndexType>(position - 1u);
+                }
+            };
+
+            std::size_t m = 0;
+            for (std::size_t i = 1; i < size; ++i)
+                if (isLms(i))
+                    ++m;
+
+            induce([&] {
+                for (std::size_t i = 1; i < size; ++i)
+                    if (isLms(i))
+                        sa[--bucket[s[i]]] = static_cast<IndexType>(i);
+            });
+            if (m == 0)
+                return sa;
+
+            // ===== Move the LMS suffixes, now sorted by their LMS substrings, to the front.
+            for (std::size_t i = 0, j = 0; i < size; ++i)
+                if (isLms(sa[i]))
+                    sa[j++] = sa[i];
+
+            // ===== Name the LMS substrings in sorted order. LMS positions are at least two apart, so the name of the
+            // ===== substring at a position can be stored at m + position / 2.
+            auto equalLms = [&](std::size_t left, std::size_t right) {
+                for (std::size_t d = 0;; ++d) {
+                    if (left + d == size || right + d == size || s[left + d] != s[right + d] ||
+                        isS[left + d] != isS[right + d])
+                        return false;
+                    if (d > 0 && (isLms(left + d) || isLms(right + d)))
+                        return isLms(left + d) && isLms(right + d);
+                }
+            };
+
+            std::fill(sa.begin() + static_cast<std::ptrdiff_t>(m), sa.end(), empty);
+            IndexType reducedUpper = 0;
+            for (std::size_t i = 0; i < m; ++i) {
+                if (i > 0 && !equalLms(sa[i - 1], sa[i]))
+                    ++reducedUpper;
+                sa[m + sa[i] / 2] = reducedUpper;
+            }
+
+            std::vector<IndexType> reduced(m);
+            for (std::size_t i = m, j = 0; i < size; ++i)
+                if (sa[i] != empty)
+                    reduced[j++] = sa[i];
+            std::vector<IndexType>().swap(sa);
+
+            // ===== Sort the reduced string; if the names are unique, the order follows directly from them.
+            std::vector<IndexType> reducedSa;
+            if (std::size_t(reducedUpper) + 1 == m) {
+                reducedSa.resize(m);
+                for (std::size_t i = 0; i < m; ++i)
+                    reducedSa[reduced[i]] = static_cast<IndexType>(i);
+            }
+            else
+                reducedSa = suffixArray<IndexType>(reduced.data(), static_cast<IndexType>(m), reducedUpper);
+            std::vector<IndexType>().swap(reduced);
+
+            // ===== Translate the sorted reduced suffixes to LMS positions, and induce the final order from them.
+            sa.resize(size);
+            for (std::size_t i = 1, j = 0; i < size; ++i)
+                if (isLms(i))
+                    sa[j++] = static_cast<IndexType>(i);
+            for (auto& position : reducedSa)
+                position = sa[position];
+
+            induce([&] {
+                for (auto i = m; i-- > 0;)
+                    sa[--bucket[s[reducedSa[i]]]] = reducedSa[i];
+            });
+
+            return sa;
+        }
+
+        /**
+         * @brief Copy a sequence of values to a string of bytes, for searching an index over elements of type T. If
+         * any of the values can not compare equal to an element of type T (e.g. a negative char, when the elements
+         * are unsigned char), the sequence is never found, and false is returned.
+         */
+        template<typename T, typename ForwardIt>
+        bool needleBytes(ForwardIt s_first, ForwardIt s_last, std::string& needle) {
+            for (; s_first != s_last; ++s_first) {
+                const auto value = narrow<T>(*s_first);
+                if (!(value == *s_first))
+                    return false;
+                needle += static_cast<char>(narrow<unsigned char>(value));
+            }
+            return true;
+        }
+
+        /**
+         * @brief Sort positions by the given key, which has at most the given number of bits, in linear time, using a
+         * least significant digit radix sort on bytes. Passes where all keys have the same byte are skipped, and short
+         * vectors are sorted with std::sort.
+         */
+        template<typename IndexType, typename Key>
+        void radixSort(std::vector<IndexType>& positions, Key key, std::size_t bits) {
+            if (positions.size() < 256) {
+                std::sort(positions.begin(), positions.end(), [&](IndexType a, IndexType b) { return key(a) < key(b); });
+                return;
+            }
+
+            std::vector<IndexType> buffer(positions.size());
+            for (std::size_t shift = 0; shift < bits; shift += 8) {
+                auto digit = [&key, shift](IndexType position) { return std::size_t(key(position) >> shift) & 0xff; };
+
+                std::array<std::size_t, 257> offsets = {};
+                for (auto position : positions)
+                    ++offsets[digit(position) + 1];
+                if (offsets[digit(positions.front()) + 1] == positions.size())
+                    continue;
+                for (std::size_t value = 0; value < 256; ++value)
+                    offsets[value + 1] += offsets[value];
+
+                for (auto position : positions)
+                    buffer[offsets[digit(position)]++] = position;
+                positions.swap(buffer);
+            }
+        }
+
+        /**
+         * @brief Sort positions in linear time, using a least significant digit radix sort on bytes.
+         */
+        template<typename IndexType>
+        void radixSort(std::vector<IndexType>& positions) {
+            radixSort(positions, [](IndexType position) { return position; }, sizeof(IndexType) * 8);
+        }
+
+        /**
+         * @brief Write iterators to the non-overlapping occurrences of a sequence of the given length, in ascending
+         * order, given the start positions of all occurrences (in any order), as trl::search_all would. The positions
+         * are sorted in O(k) time for k occurrences.
+         */
+        template<typename IndexType, typename RandomIt, typename OutputIt>
+        OutputIt reportNonOverlapping(std::vector<IndexType>& positions,
+                                      std::size_t             length,
+                                      RandomIt                first,
+                                      OutputIt                d_first) {
+            radixSort(positions);
+
+            std::size_t next = 0;
+            for (auto position : positions)
+                if (position >= next) {
+                    *(d_first++) = first + static_cast<std::ptrdiff_t>(position);
+                    next         = std::size_t(position) + length;
+                }
+
+            return d_first;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief A suffix array index over a static range of bytes, for answering many searches without rescanning it.
+     * @details The suffix array (the positions of all suffixes of the range, in sorted order) is constructed in
+     * linear time using the SA-IS algorithm, and the LCP array (the length of the longest common prefix of each suffix
+     * and the previous one in sorted order) in linear time using Kasai's algorithm. A search for a sequence of length
+     * m finds the first suffix starting with it using a binary search over the suffix array, where the comparisons
+     * skip the prefix known to match both bounds; the other k suffixes starting with it follow directly from the LCP
+     * array. The k positions are put in ascending order with a radix sort, so a search takes O(m log n + k) time,
+     * instead of the O(n) time of trl::search_all.
+     *
+     * The index refers to the range, which must not be modified or destroyed while the index is in use. It takes
+     * 2 * sizeof(IndexType) bytes per element, plus temporary memory of the same order during construction.
+     * #### Example
+     *   @code{.cpp}
+     *      auto corpus = std::string("ABHELLOAAHELLOBAX");
+     *      auto index = trl::SuffixArrayIndex(corpus.begin(), corpus.end());
+     *      auto needle = std::string("HELLO");
+     *      std::vector<decltype(corpus.begin())> results;
+     *      index.search_all(needle.begin(), needle.end(), std::back_inserter(results)); // Positions 2 and 9
+     *   @endcode
+     * @tparam RandomIt The type of the iterators to the range. The range must be contiguous, and the value_type must be
+     * a byte-sized integral type, e.g. char or unsigned char.
+     * @tparam IndexType The unsigned integral type used for positions. The default, std::uint32_t, allows ranges of up
+     * to 4 GB.
+     */
+    template<typename RandomIt, typename IndexType = std::uint32_t>
+    class SuffixArrayIndex
+    {
+        static_assert(IsContiguousIterator<RandomIt>::value, "The SuffixArrayIndex can only index contiguous ranges!");
+        static_assert(detail::IsByteComparable<typename std::iterator_traits<RandomIt>::value_type>::value,
+                      "The SuffixArrayIndex can only index sequences of bytes!");
+        static_assert(std::is_unsigned<IndexType>::value, "The IndexType must be an unsigned integral type!");
+
+    public:
+
+        /**
+         * @brief Constructor, building the index over the range [first, last).
+         * @param first The first element in the range to index.
+         * @param last One element beyond the last element in the range to index.
+         * @throws std::length_error if the range is too long for IndexType.
+         */
+        SuffixArrayIndex(RandomIt first, RandomIt last)
+            : m_first(first),
+              m_bytes(first == last ? nullptr : detail::asBytes(std::addressof(*first))),
+              m_size(checkedSize(first, last)),
+              m_suffixes(detail::suffixArray<IndexType>(m_bytes, m_size, IndexType(255))),
+              m_lcp(longestCommonPrefixes()) {}
+
+        /**
+         * @brief Search for all non-overlapping occurrences of a sequence of values in the indexed range.
+         * @details The results are the same as for trl::search_all over the indexed range, i.e. the occurrences are
+         * reported in ascending order, and an occurrence overlapping the previous one is skipped. An empty sequence is
+         * never found.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @param d_first An output iterator pointing to the first element to fill in the output container.
+         * @return An output iterator pointing to one element beyond the last element of the output container.
+         */
+        template<typename ForwardIt, typename OutputIt>
+        OutputIt search_all(ForwardIt s_first, ForwardIt s_last, OutputIt d_first) const {
+            const auto range = equalRange(s_first, s_last);
+            std::vector<IndexType> positions(m_suffixes.begin() + static_cast<std::ptrdiff_t>(range.first),
+                                             m_suffixes.begin() + static_cast<std::ptrdiff_t>(range.second));
+
+            return detail::reportNonOverlapping(positions,
+                                                static_cast<std::size_t>(std::distance(s_first, s_last)),
+                                                m_first,
+                                                d_first);
+        }
+
+        /**
+         * @brief Count all occurrences (including overlapping ones) of a sequence of values in the indexed range.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @return The number of occurrences. An empty sequence is never found.
+         */
+        template<typename ForwardIt>
+        [[nodiscard]] std::size_t count(ForwardIt s_first, ForwardIt s_last) const {
+            const auto range = equalRange(s_first, s_last);
+            return range.second - range.first;
+        }
+
+        /**
+         * @brief Get the suffix array, i.e. the start positions of the suffixes of the range in sorted order.
+         */
+        [[nodiscard]] const std::vector<IndexType>& suffix_array() const {
+            return m_suffixes;
+        }
+
+        /**
+         * @brief Get the LCP array, i.e. for each suffix in sorted order, the length of the longest common prefix with
+         * the previous suffix (0 for the first suffix).
+         */
+        [[nodiscard]] const std::vector<IndexType>& lcp_array() const {
+            return m_lcp;
+        }
+
+        /**
+         * @brief Get the number of elements in the indexed range.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return m_size;
+        }
+
+    private:
+
+        /**
+         * @brief Get the size of the range, checking that it fits in IndexType (with a value to spare as marker).
+         */
+        static IndexType checkedSize(RandomIt first, RandomIt last) {
+            const auto size = static_cast<std::size_t>(last - first);
+            if (size >= std::size_t(std::numeric_limits<IndexType>::max()))
+                throw std::length_error("The range is too long for the SuffixArrayIndex IndexType.");
+            return static_cast<IndexType>(size);
+        }
+
+        /**
+         * @brief Compute the LCP array, using Kasai's algorithm.
+         */
+        std::vector<IndexType> longestCommonPrefixes() const {
+            std::vector<IndexType> rank(m_size);
+            for (IndexType i = 0; i < m_size; ++i)
+                rank[m_suffixes[i]] = i;
+
+            std::vector<IndexType> lcp(m_size);
+            IndexType              common = 0;
+            for (IndexType position = 0; position < m_size; ++position) {
+                if (common > 0)
+                    --common;
+                if (rank[position] == 0) {
+                    common = 0;
+                    continue;
+                }
+                const auto previous = m_suffixes[rank[position] - 1];
+                while (position + common < m_size && previous + common < m_size &&
+                       m_bytes[position + common] == m_bytes[previous + common])
+                    ++common;
+                lcp[rank[position]] = common;
+            }
+            return lcp;
+        }
+
+        /**
+         * @brief Find the range [first, second) of the suffix array of the suffixes starting with the sequence.
+         */
+        template<typename ForwardIt>
+        std::pair<std::size_t, std::size_t> equalRange(ForwardIt s_first, ForwardIt s_last) const {
+            std::string needle;
+            if (!detail::needleBytes<typename std::iterator_traits<RandomIt>::value_type>(s_first, s_last, needle) ||
+                needle.empty() || m_size == 0)
+                return {0, 0};
+            const auto* bytes = detail::asBytes(needle.data());
+
+            // ===== Compare the suffix with the needle, skipping the first common elements which are known to match.
+            // ===== Returns the number of matching elements, and whether the suffix is less than the needle.
+            auto compare = [&](IndexType position, std::size_t common) {
+                const auto available = std::min(needle.size(), std::size_t(m_size - position));
+                while (common < available && m_bytes[position + common] == bytes[common])
+                    ++common;
+                const bool less = common < needle.size() &&
+                                  (common == available || m_bytes[position + common] < bytes[common]);
+                return std::make_pair(common, less);
+            };
+
+            // ===== Binary search for the first suffix not less than the needle. The suffixes between the bounds share
+            // ===== at least the minimum of the common prefixes of the bounds with the needle.
+            std::size_t low = 0, high = m_size, lowCommon = 0, highCommon = 0;
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                const auto result = compare(m_suffixes[middle], std::min(lowCommon, highCommon));
+                if (result.second) {
+                    low       = middle + 1;
+                    lowCommon = result.first;
+                }
+                else {
+                    high       = middle;
+                    highCommon = result.first;
+                }
+            }
+
+            if (low == m_size || compare(m_suffixes[low], 0).first != needle.size())
+                return {low, low};
+
+            // ===== The following suffixes start with the needle as long as they share at least its length.
+            auto end = low + 1;
+            while (end < m_size && m_lcp[end] >= needle.size())
+                ++end;
+            return {low, end};
+        }
+
+        RandomIt               m_first;    /**< The first element of the indexed range. */
+        const unsigned char*   m_bytes;    /**< The indexed range, as bytes. */
+        IndexType              m_size;     /**< The number of elements in the indexed range. */
+        std::vector<IndexType> m_suffixes; /**< The suffix array. */
+        std::vector<IndexType> m_lcp;      /**< The LCP array. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief A bit vector with constant time rank queries. The number of set bits before each block of 512 bits
+         * is stored, i.e. the directory adds 12.5% to the size of the bits.
+         */
+        class RankBitVector
+        {
+        public:
+            RankBitVector() = default;
+
+            /**
+             * @brief Constructor, creating a bit vector of size bits, all cleared.
+             */
+            explicit RankBitVector(std::size_t size) : m_words(size / 64 + 1, 0), m_blocks() {}
+
+            /**
+             * @brief Set the bit at position.
+             */
+            void set(std::size_t position) {
+                m_words[position / 64] |= std::uint64_t(1) << (position % 64);
+            }
+
+            /**
+             * @brief Build the rank directory. Must be called after all bits have been set.
+             */
+            void build() {
+                m_blocks.assign(m_words.size() / 8 + 1, 0);
+                std::uint64_t count = 0;
+                for (std::size_t word = 0; word < m_words.size(); ++word) {
+                    if (word % 8 == 0)
+                        m_blocks[word / 8] = count;
+                    count += static_cast<std::uint64_t>(popCount(m_words[word]));
+                }
+            }
+
+            /**
+             * @brief Get the bit at position.
+             */
+            [[nodiscard]] bool get(std::size_t position) const {
+                return ((m_words[position / 64] >> (position % 64)) & 1) != 0;
+            }
+
+            /**
+             * @brief Count the set bits in the range [0, position).
+             */
+            [[nodiscard]] std::size_t rank1(std::size_t position) const {
+                const auto word  = position / 64;
+                auto       count = m_blocks[word / 8];
+                for (auto i = word / 8 * 8; i < word; ++i)
+                    count += static_cast<std::uint64_t>(popCount(m_words[i]));
+                if (position % 64 != 0)
+                    count += static_cast<std::uint64_t>(popCount(m_words[word] << (64 - position % 64)));
+                return narrow<std::size_t>(count);
+            }
+
+            /**
+             * @brief Count the cleared bits in the range [0, position).
+             */
+            [[nodiscard]] std::size_t rank0(std::size_t position) const {
+                return position - rank1(position);
+            }
+
+            /**
+             * @brief Get the number of bytes used.
+             */
+            [[nodiscard]] std::size_t memory() const {
+                return (m_words.size() + m_blocks.size()) * sizeof(std::uint64_t);
+            }
+
+        private:
+            std::vector<std::uint64_t> m_words  = {}; /**< The bits. */
+            std::vector<std::uint64_t> m_blocks = {}; /**< The number of set bits before each block of eight words. */
+        };
+
+        /**
+         * @brief A wavelet matrix over a sequence of bytes, supporting access and rank queries in O(8) time. Each
+         * of the eight levels holds one bit of each byte (most significant first), in the order given by stably
+         * sorting the sequence on the bits of the previous levels.
+         */
+        class WaveletMatrix
+        {
+        public:
+            WaveletMatrix() = default;
+
+            /**
+             * @brief Constructor, building the matrix for a sequence of bytes. The sequence is used as scratch space.
+             */
+            explicit WaveletMatrix(std::vector<unsigned char>& sequence) : m_levels(), m_zeros(), m_begin() {
+                std::vector<unsigned char> next(sequence.size());
+                for (int level = 0; level < 8; ++level) {
+                    const auto shift = 7 - level;
+                    RankBitVector bits(sequence.size());
+                    std::size_t   zeros = 0;
+                    for (std::size_t i = 0; i < sequence.size(); ++i) {
+                        if ((sequence[i] >> shift) & 1)
+                            bits.set(i);
+                        else
+                            ++zeros;
+                    }
+                    bits.build();
+
+                    // ===== Stable partition: the elements with a cleared bit first.
+                    std::size_t zero = 0, one = zeros;
+                    for (auto value : sequence)
+                        next[((value >> shift) & 1) ? one++ : zero++] = value;
+                    sequence.swap(next);
+
+                    m_levels[static_cast<std::size_t>(level)] = std::move(bits);
+                    m_zeros[static_cast<std::size_t>(level)]  = zeros;
+                }
+
+                // ===== In the final order, the elements are sorted by value (with the bits reversed), so the start
+                // ===== of each value is the number of elements ordered before it.
+                std::size_t counts[256] = {};
+                for (auto value : sequence)
+                    ++counts[value];
+                for (unsigned value = 0; value < 256; ++value) {
+                    std::size_t position = 0;
+                    for (unsigned other = 0; other < 256; ++other)
+                        if (reverseBits(other) < reverseBits(value))
+                            position += counts[other];
+                    m_begin[value] = position;
+                }
+            }
+
+            /**
+             * @brief Count the occurrences of value in the range [0, position).
+             */
+            [[nodiscard]] std::size_t rank(unsigned char value, std::size_t position) const {
+                for (std::size_t level = 0; level < 8; ++level) {
+                    if ((value >> (7 - level)) & 1)
+                        position = m_zeros[level] + m_levels[level].rank1(position);
+                    else
+                        position = m_levels[level].rank0(position);
+                }
+                return position - m_begin[value];
+            }
+
+            /**
+             * @brief Get the element at position, and the number of occurrences of it in the range [0, position).
+             */
+            [[nodiscard]] std::pair<unsigned char, std::size_t> accessRank(std::size_t position) const {
+                unsigned value = 0;
+                for (std::size_t level = 0; level < 8; ++level) {
+                    value <<= 1;
+                    if (m_levels[level].get(position)) {
+                        value |= 1;
+                        position = m_zeros[level] + m_levels[level].rank1(position);
+                    }
+                    else
+                        position = m_levels[level].rank0(position);
+                }
+                return {static_cast<unsigned char>(value), position - m_begin[value]};
+            }
+
+            /**
+             * @brief Get the number of bytes used.
+             */
+            [[nodiscard]] std::size_t memory() const {
+                std::size_t result = sizeof(*this);
+                for (const auto& level : m_levels)
+                    result += level.memory();
+                return result;
+            }
+
+        private:
+            static unsigned reverseBits(unsigned value) {
+                unsigned result = 0;
+                for (int bit = 0; bit < 8; ++bit, value >>= 1)
+                    result = (result << 1) | (value & 1);
+                return result;
+            }
+
+            std::array<RankBitVector, 8> m_levels = {}; /**< The bits of each level. */
+            std::array<std::size_t, 8>   m_zeros  = {}; /**< The number of cleared bits in each level. */
+            std::array<std::size_t, 256> m_begin  = {}; /**< The position of each value after the last level. */
+        };
+
+        /**
+         * @brief Count the bytes equal to value in the range [first, last). With SSE2, 16 bytes are compared at a time,
+         * and the matches are summed in byte lanes, which are added up every 255 chunks.
+         */
+        inline std::size_t countByte(const unsigned char* first, const unsigned char* last, unsigned char value) {
+            std::size_t count = 0;
+#if TROLDALGO_HAS_SSE2
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+            while (last - first >= 16) {
+                __m128i lanes = _mm_setzero_si128();
+                for (int chunk = 0; chunk < 255 && last - first >= 16; ++chunk, first += 16)
+                    lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), needle));
+                const __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+                count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+            }
+#endif
+            for (; first != last; ++first)
+                if (*first == value)
+                    ++count;
+            return count;
+        }
+
+        /**
+         * @brief The Burrows-Wheeler transform of a string, with a sample of its suffix array, as built by buildBwt.
+         * @details There is a row for each suffix of the string (including the empty suffix, in row 0), in sorted
+         * order, holding the element preceding the suffix. The row of the whole string holds a zero.
+         */
+        template<typename IndexType>
+        struct SampledBwt
+        {
+            std::vector<unsigned char> bwt      = {}; /**< The element preceding the suffix of each row. */
+            std::size_t                sentinel = 0;  /**< The row of the whole string. */
+            std::vector<bool>          sampled  = {}; /**< For each row, whether the position of its suffix is sampled. */
+            std::vector<IndexType>     samples  = {}; /**< The sampled positions, in row order. */
+        };
+
+        /**
+         * @brief Build the Burrows-Wheeler transform of the string s of length n, sampling the positions which are
+         * multiples of sample_rate, without building the suffix array of the whole string.
+         * @details The string is processed in 16 blocks, from the end, and the rows of the suffixes starting in each
+         * block are merged into the BWT of the suffixes after it. The insertion point of each suffix in the block (the
+         * number of rows smaller than it) follows from the insertion point of the next suffix with one rank query,
+         * as in backward search; the number of occurrences of each value is stored for every 1024th row, and counted
+         * from there. The suffixes of the block are ordered by their insertion points, then by their first element,
+         * and then by the order of the next suffix, i.e. as the suffixes of the string of (insertion point, element)
+         * pairs, which are sorted with SA-IS. Hence, positions are only stored for one block at a time, at the cost of
+         * rewriting the BWT for each block (2.9 bytes per element at the peak, measured on 20 MB of log text with
+         * std::uint32_t).
+         */
+        template<typename IndexType>
+        SampledBwt<IndexType> buildBwt(const unsigned char* s, std::size_t n, std::size_t sample_rate) {
+            constexpr std::size_t stride = 1024;
+
+            SampledBwt<IndexType> result;
+            result.bwt.assign(1, 0);
+            result.sampled.assign(1, true);
+            result.samples.assign(1, static_cast<IndexType>(n));
+
+            std::size_t counts[256] = {};
+            const auto  blockSize = (n + 15) / 16;
+            for (auto end = n; end > 0;) {
+                const auto start  = end - std::min(end, blockSize);
+                const auto length = end - start;
+                const auto rows   = result.bwt.size();
+                const auto* bwt   = result.bwt.data();
+
+                // ===== The insertion point of each suffix in the block, starting from the row of the suffix after
+                // ===== the block. This row is not counted by rank, as its preceding element is in the block.
+                std::vector<IndexType> points(length);
+                {
+                    std::size_t smaller[256];
+                    for (std::size_t value = 0, total = 1; value < 256; total += counts[value++])
+                        smaller[value] = total;
+
+                    std::vector<IndexType>     occurrences((rows / stride + 1) * 256);
+                    std::array<IndexType, 256> running = {};
+                    for (std::size_t row = 0; row <= rows; ++row) {
+                        if (row % stride == 0)
+                            std::copy(running.begin(), running.end(), occurrences.begin() + static_cast<std::ptrdiff_t>(row / stride * 256));
+                        if (row < rows && row != result.sentinel)
+                            ++running[bwt[row]];
+                    }
+
+                    // ===== Count from the nearest stored row before or after the row.
+                    auto rank = [&](unsigned char value, std::size_t row) {
+                        const auto base = row / stride * stride;
+                        if (row - base <= stride / 2 || base + stride > rows) {
+                            auto count = std::size_t(occurrences[base / stride * 256 + value]) + countByte(bwt + base, bwt + row, value);
+                            if (value == 0 && result.sentinel >= base && result.sentinel < row)
+                                --count;
+                            return count;
+                        }
+                        auto count = std::size_t(occurrences[(base / stride + 1) * 256 + value]) - countByte(bwt + row, bwt + base + stride, value);
+                        if (value == 0 && result.sentinel >= row && result.sentinel < base + stride)
+                            ++count;
+                        return count;
+                    };
+
+                    std::size_t point = result.sentinel;
+                    for (auto i = length; i-- > 0;) {
+                        const auto value = s[start + i];
+                        point            = smaller[value] + rank(value, point);
+                        points[i]        = static_cast<IndexType>(point);
+                    }
+                }
+
+                // ===== Name the (insertion point, element) pairs in sorted order. The suffix after the block is
+                // ===== represented by a terminal, which is ordered between the insertion points around its row.
+                std::vector<IndexType> sorted;
+                {
+                    auto key = [&](std::size_t i) {
+                        return i == length ? (std::uint64_t(result.sentinel) * 2 + 1) << 8
+                                           : (std::uint64_t(points[i]) * 2) << 8 | s[start + i];
+                    };
+
+                    std::vector<IndexType> order(length + 1);
+                    for (std::size_t i = 0; i <= length; ++i)
+                        order[i] = static_cast<IndexType>(i);
+                    radixSort(order, key, sizeof(IndexType) * 8 + 10);
+
+                    std::vector<IndexType> names(length + 1);
+                    IndexType              upper = 0;
+                    for (std::size_t i = 0; i <= length; ++i) {
+                        if (i > 0 && key(order[i]) != key(order[i - 1]))
+                            ++upper;
+                        names[order[i]] = upper;
+                    }
+                    std::vector<IndexType>().swap(order);
+
+                    sorted = suffixArray<IndexType>(names.data(), static_cast<IndexType>(length + 1), upper);
+                }
+
+                // ===== Merge the rows of the block into the BWT. The row of the suffix after the block is now
+                // ===== preceded by the last element of the block, and the row of the first suffix in the block
+                // ===== takes its place.
+                SampledBwt<IndexType> merged;
+                merged.bwt.resize(rows + length);
+                merged.sampled.resize(rows + length);
+                merged.samples.reserve(result.samples.size() + length / sample_rate + 1);
+
+                std::size_t row = 0, target = 0, sample = 0;
+                auto copyRows = [&](std::size_t until) {
+                    std::copy(bwt + row, bwt + until, merged.bwt.begin() + static_cast<std::ptrdiff_t>(target));
+                    if (result.sentinel >= row && result.sentinel < until)
+                        merged.bwt[target + result.sentinel - row] = s[end - 1];
+                    for (; row < until; ++row, ++target)
+                        if (result.sampled[row]) {
+                            merged.sampled[target] = true;
+                            merged.samples.push_back(result.samples[sample++]);
+                        }
+                };
+
+                for (auto i : sorted) {
+                    if (i == length)
+                        continue;
+                    copyRows(points[i]);
+                    const auto position = start + i;
+                    if (i == 0)
+                        merged.sentinel = target;
+                    merged.bwt[target] = i == 0 ? 0 : s[position - 1];
+                    if (position % sample_rate == 0) {
+                        merged.sampled[target] = true;
+                        merged.samples.push_back(static_cast<IndexType>(position));
+                    }
+                    ++target;
+                }
+                copyRows(rows);
+
+                for (auto i = start; i < end; ++i)
+                    ++counts[s[i]];
+                result = std::move(merged);
+                end    = start;
+            }
+
+            return result;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief A compressed full-text index (FM-index) over a static range of bytes.
+     * @details The index stores the Burrows-Wheeler transform (BWT) of the range in a wavelet matrix, and a sample of
+     * the suffix array. Counting the occurrences of a sequence of length m uses backward search, with two rank
+     * queries per element, and takes O(m) time regardless of the size of the range. Locating the occurrences takes
+     * up to sample_rate - 1 additional steps per occurrence, to walk back to a sampled position.
+     *
+     * The index takes about 1.3 bytes per element, plus sizeof(IndexType) / sample_rate bytes per element for the
+     * samples, compared to 2 * sizeof(IndexType) bytes per element for trl::SuffixArrayIndex; the range itself is not
+     * used after construction. The BWT is built block by block, without the suffix array of the whole range, so the
+     * peak memory is about 3.4 bytes per element (measured on 20 MB of log text with std::uint32_t), reached while the
+     * wavelet matrix is built, compared to 3 * sizeof(IndexType) bytes per element for trl::SuffixArrayIndex. In
+     * exchange, construction takes about twice as long as sorting the suffixes at once.
+     *
+     * The index refers to the range, as the results are iterators into it.
+     * #### Example
+     *   @code{.cpp}
+     *      auto corpus = std::string("ABHELLOAAHELLOBAX");
+     *      auto index = trl::FmIndex(corpus.begin(), corpus.end());
+     *      auto needle = std::string("HELLO");
+     *      auto count = index.count(needle.begin(), needle.end()); // 2
+     *   @endcode
+     * @tparam RandomIt The type of the iterators to the range. The range must be contiguous, and the value_type must be
+     * a byte-sized integral type, e.g. char or unsigned char.
+     * @tparam IndexType The unsigned integral type used for the sampled positions. The default, std::uint32_t, allows
+     * ranges of up to 4 GB.
+     */
+    template<typename RandomIt, typename IndexType = std::uint32_t>
+    class FmIndex
+    {
+        static_assert(IsContiguousIterator<RandomIt>::value, "The FmIndex can only index contiguous ranges!");
+        static_assert(detail::IsByteComparable<typename std::iterator_traits<RandomIt>::value_type>::value,
+                      "The FmIndex can only index sequences of bytes!");
+        static_assert(std::is_unsigned<IndexType>::value, "The IndexType must be an unsigned integral type!");
+
+    public:
+
+        /**
+         * @brief Constructor, building the index over the range [first, last).
+         * @param first The first element in the range to index.
+         * @param last One element beyond the last element in the range to index.
+         * @param sample_rate The distance between the sampled positions of the suffix array. Larger values give a
+         * smaller index, and slower locate queries.
+         * @throws std::length_error if the range is too long for IndexType.
+         * @throws std::invalid_argument if sample_rate is zero.
+         */
+        FmIndex(RandomIt first, RandomIt last, std::size_t sample_rate = 32)
+            : m_first(first),
+              m_size(static_cast<std::size_t>(last - first)),
+              m_sampleRate(sample_rate),
+              m_sentinel(0),
+              m_counts(),
+              m_bwt(),
+              m_sampled(),
+              m_samples() {
+
+            if (sample_rate == 0)
+                throw std::invalid_argument("The FmIndex sample rate must be positive.");
+            if (m_size >= std::size_t(std::numeric_limits<IndexType>::max()))
+                throw std::length_error("The range is too long for the FmIndex IndexType.");
+
+            const auto* bytes = m_size == 0 ? nullptr : detail::asBytes(std::addressof(*first));
+
+            // ===== The BWT has a row for each suffix of the range followed by a sentinel, which is smaller than all
+            // ===== elements. The row for the whole range (where the BWT element is the sentinel) is recorded
+            // ===== separately, and holds a zero in the wavelet matrix.
+            auto transform = detail::buildBwt<IndexType>(bytes, m_size, m_sampleRate);
+            m_sentinel     = transform.sentinel;
+            m_samples      = std::move(transform.samples);
+            m_sampled      = detail::RankBitVector(m_size + 1);
+            for (std::size_t row = 0; row <= m_size; ++row)
+                if (transform.sampled[row])
+                    m_sampled.set(row);
+            m_sampled.build();
+            std::vector<bool>().swap(transform.sampled);
+
+            // ===== The start of each value in the sorted suffixes (the first row holds the sentinel).
+            std::size_t histogram[256] = {};
+            for (std::size_t i = 0; i < m_size; ++i)
+                ++histogram[bytes[i]];
+            for (std::size_t value = 0, total = 1; value < 256; total += histogram[value++])
+                m_counts[value] = total;
+
+            m_bwt = detail::WaveletMatrix(transform.bwt);
+        }
+
+        /**
+         * @brief Count all occurrences (including overlapping ones) of a sequence of values in the indexed range.
+         * @details This takes O(m) time for a sequence of length m, regardless of the size of the range.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @return The number of occurrences. An empty sequence is never found.
+         */
+        template<typename ForwardIt>
+        [[nodiscard]] std::size_t count(ForwardIt s_first, ForwardIt s_last) const {
+            const auto rows = backwardSearch(s_first, s_last);
+            return rows.second - rows.first;
+        }
+
+        /**
+         * @brief Search for all non-overlapping occurrences of a sequence of values in the indexed range.
+         * @details The results are the same as for trl::search_all over the indexed range, i.e. the occurrences are
+         * reported in ascending order, and an occurrence overlapping the previous one is skipped. An empty sequence is
+         * never found.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @param d_first An output iterator pointing to the first element to fill in the output container.
+         * @return An output iterator pointing to one element beyond the last element of the output container.
+         */
+        template<typename ForwardIt, typename OutputIt>
+        OutputIt search_all(ForwardIt s_first, ForwardIt s_last, OutputIt d_first) const {
+            const auto rows = backwardSearch(s_first, s_last);
+
+            std::vector<IndexType> positions;
+            positions.reserve(rows.second - rows.first);
+            for (auto row = rows.first; row < rows.second; ++row)
+                positions.push_back(locate(row));
+
+            return detail::reportNonOverlapping(positions,
+                                                static_cast<std::size_t>(std::distance(s_first, s_last)),
+                                                m_first,
+                                                d_first);
+        }
+
+        /**
+         * @brief Get the number of elements in the indexed range.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return m_size;
+        }
+
+        /**
+         * @brief Get the approximate number of bytes used by the index.
+         */
+        [[nodiscard]] std::size_t memory_usage() const {
+            return sizeof(*this) + m_bwt.memory() + m_sampled.memory() + m_samples.capacity() * sizeof(IndexType);
+        }
+
+    private:
+
+        /**
+         * @brief Count the occurrences of value in the first rows of the BWT, excluding the sentinel.
+         */
+        std::size_t rank(unsigned char value, std::size_t row) const {
+            auto result = m_bwt.rank(value, row);
+            if (value == 0 && row > m_sentinel && m_sentinel != 0)
+                --result;
+            return result;
+        }
+
+        /**
+         * @brief Find the rows [first, second) of the sorted suffixes starting with the sequence, by extending the
+         * sequence one element at a time from the end.
+         */
+        template<typename ForwardIt>
+        std::pair<std::size_t, std::size_t> backwardSearch(ForwardIt s_first, ForwardIt s_last) const {
+            std::string needle;
+            if (!detail::needleBytes<typename std::iterator_traits<RandomIt>::value_type>(s_first, s_last, needle) ||
+                needle.empty() || m_size == 0)
+                return {0, 0};
+
+            std::size_t first = 0, last = m_size + 1;
+            for (auto it = needle.rbegin(); it != needle.rend() && first < last; ++it) {
+                const auto value = static_cast<unsigned char>(*it);
+                first            = m_counts[value] + rank(value, first);
+                last             = m_counts[value] + rank(value, last);
+            }
+            return first < last ? std::make_pair(first, last) : std::make_pair(std::size_t(0), std::size_t(0));
+        }
+
+        /**
+         * @brief Find the position in the range of the suffix in a row, by walking back (using the LF mapping) to a
+         * row with a sampled position.
+         */
+        IndexType locate(std::size_t row) const {
+            std::size_t steps = 0;
+            while (!m_sampled.get(row)) {
+                const auto element = m_bwt.accessRank(row);
+                row                = m_counts[element.first] + element.second -
+                                     (element.first == 0 && row > m_sentinel && m_sentinel != 0 ? 1 : 0);
+                ++steps;
+            }
+            return static_cast<IndexType>(m_samples[m_sampled.rank1(row)] + steps);
+        }
+
+        RandomIt                     m_first;      /**< The first element of the indexed range. */
+        std::size_t                  m_size;       /**< The number of elements in the indexed range. */
+        std::size_t                  m_sampleRate; /**< The distance between the sampled positions. */
+        std::size_t                  m_sentinel;   /**< The row where the BWT holds the sentinel. */
+        std::array<std::size_t, 256> m_counts;     /**< The first row of the suffixes starting with each value. */
+        detail::WaveletMatrix        m_bwt;        /**< The BWT (without the sentinel). */
+        detail::RankBitVector        m_sampled;    /**< The rows with a sampled position. */
+        std::vector<IndexType>       m_samples;    /**< The sampled positions, in row order. */
+    };
+
+    /**
+     * @brief An index of the positions of each byte value in a static range, for answering many trl::find_all queries
+     * without rescanning it.
+     * @details The posting lists (the positions of each value, in ascending order) are stored in a counting sort
+     * layout: one array with the positions of all elements, grouped by value, and an array of 257 offsets to the start
+     * of each group. The index is built in two passes over the range (counting and scattering), and a query for k
+     * elements takes O(k) time, with no scan.
+     *
+     * The index takes sizeof(IndexType) bytes per element. It refers to the range, as the results are iterators into
+     * it, so the range must not be modified or destroyed while the index is in use.
+     * #### Example
+     *   @code{.cpp}
+     *      auto str = std::string("ABCDDCBAABCDDCBAX");
+     *      auto index = trl::PostingListIndex(str.begin(), str.end());
+     *      std::vector<decltype(str.begin())> results;
+     *      index.find_all(std::back_inserter(results), 'A'); // Positions 0, 7, 8 and 15
      *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the search range.
-     * @param s_last The last element in the search range.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
+     * @tparam RandomIt The type of the iterators to the range. The value_type must be a byte-sized integral type, e.g.
+     * char or unsigned char.
+     * @tparam IndexType The unsigned integral type used for positions. The default, std::uint32_t, allows ranges of up
+     * to 4 GB.
+     */
+    template<typename RandomIt, typename IndexType = std::uint32_t>
+    class PostingListIndex
+    {
+        using ValueType = typename std::iterator_traits<RandomIt>::value_type;
+
+        static_assert(IsRandomAccessIterator<RandomIt>::value, "The PostingListIndex can only index random access ranges!");
+        static_assert(detail::IsByteComparable<ValueType>::value, "The PostingListIndex can only index sequences of bytes!");
+        static_assert(std::is_unsigned<IndexType>::value, "The IndexType must be an unsigned integral type!");
+
+    public:
+
+        /**
+         * @brief Constructor, building the index over the range [first, last).
+         * @param first The first element in the range to index.
+         * @param last One element beyond the last element in the range to index.
+         * @throws std::length_error if the range is too long for IndexType.
+         */
+        PostingListIndex(RandomIt first, RandomIt last)
+            : m_first(first),
+              m_offsets(),
+              m_positions() {
+
+            const auto size = static_cast<std::size_t>(last - first);
+            if (size > std::size_t(std::numeric_limits<IndexType>::max()))
+                throw std::length_error("The range is too long for the PostingListIndex IndexType.");
+
+            // ===== Count the elements of each value, and compute the start of each group.
+            std::array<IndexType, 257> counts = {};
+            for (auto it = first; it != last; ++it)
+                ++counts[std::size_t(detail::narrow<unsigned char>(*it)) + 1];
+            for (std::size_t value = 0; value < 256; ++value)
+                counts[value + 1] += counts[value];
+            m_offsets = counts;
+
+            // ===== Scatter the positions to their groups, in ascending order.
+            m_positions.resize(size);
+            IndexType position = 0;
+            for (auto it = first; it != last; ++it, ++position)
+                m_positions[counts[detail::narrow<unsigned char>(*it)]++] = position;
+        }
+
+        /**
+         * @brief Finds all elements of a given value in the indexed range.
+         * @details The results are the same as for trl::find_all over the indexed range, in ascending order.
+         * @param d_first An output iterator pointing to the first element to fill in the output container.
+         * @param value The value to find.
+         * @return An output iterator pointing to one element beyond the last element of the output container.
+         */
+        template<typename OutputIt, typename T>
+        OutputIt find_all(OutputIt d_first, const T& value) const {
+            const auto list = positions(value);
+            for (auto it = list.first; it != list.second; ++it)
+                *(d_first++) = m_first + static_cast<std::ptrdiff_t>(*it);
+            return d_first;
+        }
+
+        /**
+         * @brief Count the elements of a given value in the indexed range, in constant time.
+         */
+        template<typename T>
+        [[nodiscard]] std::size_t count(const T& value) const {
+            const auto list = positions(value);
+            return static_cast<std::size_t>(list.second - list.first);
+        }
+
+        /**
+         * @brief Get the posting list of a value, i.e. the positions of the elements with the value, in ascending
+         * order, as a pair of pointers to the first and one beyond the last position.
+         */
+        template<typename T>
+        [[nodiscard]] std::pair<const IndexType*, const IndexType*> positions(const T& value) const {
+            if (!detail::isRepresentable<ValueType>(value) || m_positions.empty())
+                return {nullptr, nullptr};
+
+            const auto byte = detail::narrow<unsigned char>(detail::narrow<ValueType>(value));
+            return {m_positions.data() + m_offsets[byte], m_positions.data() + m_offsets[std::size_t(byte) + 1]};
+        }
+
+        /**
+         * @brief Get the number of elements in the indexed range.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return m_positions.size();
+        }
+
+    private:
+        RandomIt                   m_first;     /**< The first element of the indexed range. */
+        std::array<IndexType, 257> m_offsets;   /**< The start of the positions of each value, and the end of the last. */
+        std::vector<IndexType>     m_positions; /**< The positions of all elements, grouped by value. */
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Get the default number of threads: the number of hardware threads, or one if threads are not enabled
+         * (see TROLDALGO_USE_THREADS).
+         */
+        inline std::size_t defaultThreads() {
+#if TROLDALGO_USE_THREADS
+            return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+#else
+            return 1;
+#endif
+        }
+
+        /**
+         * @brief Call function(begin, end, thread) for consecutive parts of the range [0, count), on up to threads
+         * threads (the calling thread is used if only one is needed). An exception thrown by the function is
+         * rethrown, after all threads have finished. If threads are not enabled (see TROLDALGO_USE_THREADS), the parts
+         * are processed one after the other on the calling thread.
+         */
+        template<typename Function>
+        void parallelFor(std::size_t count, std::size_t threads, Function function) {
+            threads = std::max<std::size_t>(1, std::min(threads, count));
+            if (threads == 1) {
+                function(std::size_t(0), count, std::size_t(0));
+                return;
+            }
+
+#if !TROLDALGO_USE_THREADS
+            for (std::size_t thread = 0; thread < threads; ++thread)
+                function(count * thread / threads, count * (thread + 1) / threads, thread);
+#else
+
+            std::vector<std::exception_ptr> errors(threads);
+            std::vector<std::thread>        workers;
+            auto                            work = [&](std::size_t thread) {
+                try {
+                    function(count * thread / threads, count * (thread + 1) / threads, thread);
+                }
+                catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            try {
+                for (std::size_t thread = 1; thread < threads; ++thread)
+                    workers.emplace_back(work, thread);
+            }
+            catch (...) {
+                for (auto& worker : workers)
+                    worker.join();
+                throw;
+            }
+            work(0);
+            for (auto& worker : workers)
+                worker.join();
+
+            for (const auto& error : errors)
+                if (error)
+                    std::rethrow_exception(error);
+#endif
+        }
+    }  // namespace detail
+
+    /**
+     * @brief The result of a search in a collection of documents: the document, and the position of the match in it.
+     * @tparam Iter The type of the iterators of the documents.
+     */
+    template<typename Iter>
+    struct DocumentMatch
+    {
+        std::size_t document; /**< The index of the document in the collection. */
+        Iter        position; /**< The first element of the match. */
+    };
+
+    /**
+     * @brief A trigram inverted index over a collection of documents, for finding the documents which may contain a
+     * sequence without scanning all of them.
+     * @details For each trigram (sequence of three bytes) in the documents, the index holds a posting list with the
+     * (ascending) indices of the documents containing it. A search for a sequence of at least three elements
+     * intersects the posting lists of its trigrams, starting with the shortest, and only the remaining candidate
+     * documents are searched with trl::search_all. Shorter sequences can not be filtered, so all documents are
+     * searched.
+     *
+     * Documents can be added at any time, and are given consecutive indices. The trigrams of the documents added in a
+     * single call are extracted in parallel (if TROLDALGO_USE_THREADS is enabled), and the results are merged in
+     * document order. The index refers to the
+     * documents, which must not be modified, moved or destroyed while the index is in use (e.g. a std::vector of
+     * documents must not reallocate).
+     * #### Example
+     *   @code{.cpp}
+     *      auto documents = std::vector<std::string> { "GET /index.html", "POST /form", "GET /form" };
+     *      auto index = trl::TrigramIndex<std::string>();
+     *      index.add(documents.begin(), documents.end());
+     *      auto needle = std::string("/form");
+     *      std::vector<trl::DocumentMatch<std::string::const_iterator>> results;
+     *      index.search_all(needle.begin(), needle.end(), std::back_inserter(results)); // Documents 1 and 2
+     *   @endcode
+     * @tparam Document The type of the documents, e.g. std::string or std::vector<char>. The documents must be
+     * contiguous containers of bytes.
+     */
+    template<typename Document>
+    class TrigramIndex
+    {
+        using Iterator  = decltype(std::begin(std::declval<const Document&>()));
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        using Postings  = std::unordered_map<std::uint32_t, std::vector<std::uint32_t>>;
+
+        static_assert(IsContiguousIterator<Iterator>::value, "The TrigramIndex can only index contiguous documents!");
+        static_assert(detail::IsByteComparable<ValueType>::value, "The TrigramIndex can only index documents of bytes!");
+
+    public:
+
+        /**
+         * @brief Add a range of documents to the index.
+         * @param d_first The first document to add.
+         * @param d_last One beyond the last document to add.
+         * @param threads The number of threads used to extract the trigrams. By default, the number of hardware
+         * threads is used (or one, if TROLDALGO_USE_THREADS is not enabled).
+         * @return The index of the first document added.
+         * @throws std::length_error if the total number of documents exceeds the range of std::uint32_t. If an
+         * exception is thrown, the index is left as it was before the call.
+         */
+        template<typename ForwardIt>
+        std::size_t add(ForwardIt d_first, ForwardIt d_last, std::size_t threads = detail::defaultThreads()) {
+            const auto            first = m_documents.size();
+            std::vector<Postings> parts;
+            try {
+                for (; d_first != d_last; ++d_first)
+                    m_documents.push_back(std::addressof(*d_first));
+                if (m_documents.size() > std::size_t(std::numeric_limits<std::uint32_t>::max()))
+                    throw std::length_error("The TrigramIndex can not hold more than 2^32 - 1 documents.");
+
+                // ===== Each thread collects the posting lists of a consecutive part of the new documents, so
+                // ===== appending the parts in order keeps the posting lists sorted.
+                const auto count = m_documents.size() - first;
+                parts.resize(std::max<std::size_t>(1, std::min(threads, count)));
+                detail::parallelFor(count, parts.size(), [&](std::size_t begin, std::size_t end, std::size_t thread) {
+                    std::vector<std::uint32_t> trigrams;
+                    for (auto document = first + begin; document < first + end; ++document) {
+                        trigrams.clear();
+                        extractTrigrams(*m_documents[document], trigrams);
+                        for (auto trigram : trigrams)
+                            parts[thread][trigram].push_back(static_cast<std::uint32_t>(document));
+                    }
+                });
+
+                for (auto& part : parts)
+                    for (auto& postings : part) {
+                        auto& list = m_postings[postings.first];
+                        list.insert(list.end(), postings.second.begin(), postings.second.end());
+                    }
+            }
+            catch (...) {
+                // ===== Remove the new documents, and any of their postings already merged, so that no document is
+                // ===== indexed without its postings.
+                for (auto& part : parts)
+                    for (auto& postings : part) {
+                        auto found = m_postings.find(postings.first);
+                        if (found == m_postings.end())
+                            continue;
+                        auto& list = found->second;
+                        while (!list.empty() && list.back() >= first)
+                            list.pop_back();
+                    }
+                m_documents.resize(first);
+                throw;
+            }
+
+            return first;
+        }
+
+        /**
+         * @brief Add a single document to the index.
+         * @return The index of the document.
+         */
+        std::size_t add(const Document& document) {
+            return add(std::addressof(document), std::addressof(document) + 1, 1);
+        }
+
+        /**
+         * @brief Find the candidate documents for a sequence of values, i.e. the documents containing all of its
+         * trigrams. The indices of the candidates are written in ascending order.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @param d_first An output iterator pointing to the first element to fill in the output container.
+         * @return An output iterator pointing to one element beyond the last element of the output container.
+         */
+        template<typename ForwardIt, typename OutputIt>
+        OutputIt candidates(ForwardIt s_first, ForwardIt s_last, OutputIt d_first) const {
+            std::string needle;
+            if (!detail::needleBytes<ValueType>(s_first, s_last, needle) || needle.empty())
+                return d_first;
+
+            if (needle.size() < 3) {
+                for (std::size_t document = 0; document < m_documents.size(); ++document)
+                    *(d_first++) = document;
+                return d_first;
+            }
+
+            std::vector<std::uint32_t> trigrams;
+            extractTrigrams(needle, trigrams);
+
+            std::vector<const std::vector<std::uint32_t>*> lists;
+            for (auto trigram : trigrams) {
+                auto found = m_postings.find(trigram);
+                if (found == m_postings.end())
+                    return d_first;
+                lists.push_back(&found->second);
+            }
+            std::sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+
+            // ===== Intersect the shortest list with the others, using binary searches from the previous position.
+            std::vector<std::uint32_t> result = *lists.front();
+            for (auto list = std::next(lists.begin()); list != lists.end() && !result.empty(); ++list) {
+                auto position = (*list)->begin();
+                auto keep     = result.begin();
+                for (auto document : result) {
+                    position = std::lower_bound(position, (*list)->end(), document);
+                    if (position == (*list)->end())
+                        break;
+                    if (*position == document)
+                        *(keep++) = document;
+                }
+                result.erase(keep, result.end());
+            }
+
+            for (auto document : result)
+                *(d_first++) = std::size_t(document);
+            return d_first;
+        }
+
+        /**
+         * @brief Search for all non-overlapping occurrences of a sequence of values in the documents.
+         * @details The candidate documents are searched with trl::search_all, in ascending order, and a
+         * trl::DocumentMatch is written for each occurrence.
+         * @param s_first The first element in the search range.
+         * @param s_last The last element in the search range.
+         * @param d_first An output iterator pointing to the first element to fill in the output container.
+         * @return An output iterator pointing to one element beyond the last element of the output container.
+         */
+        template<typename ForwardIt, typename OutputIt>
+        OutputIt search_all(ForwardIt s_first, ForwardIt s_last, OutputIt d_first) const {
+            std::vector<std::size_t> documents;
+            candidates(s_first, s_last, std::back_inserter(documents));
+
+            std::vector<Iterator> positions;
+            for (auto document : documents) {
+                positions.clear();
+                const auto& content = *m_documents[document];
+                trl::search_all(std::begin(content), std::end(content), s_first, s_last, std::back_inserter(positions));
+                for (auto position : positions)
+                    *(d_first++) = DocumentMatch<Iterator> {document, position};
+            }
+            return d_first;
+        }
+
+        /**
+         * @brief Get a document in the index.
+         */
+        [[nodiscard]] const Document& document(std::size_t index) const {
+            return *m_documents[index];
+        }
+
+        /**
+         * @brief Get the number of documents in the index.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return m_documents.size();
+        }
+
+    private:
+
+        /**
+         * @brief Get the distinct trigrams of a document, in ascending order.
+         */
+        template<typename Container>
+        static void extractTrigrams(const Container& document, std::vector<std::uint32_t>& trigrams) {
+            const auto size = static_cast<std::size_t>(std::distance(std::begin(document), std::end(document)));
+            if (size < 3)
+                return;
+
+            const auto*   bytes   = detail::asBytes(std::addressof(*std::begin(document)));
+            std::uint32_t trigram = (std::uint32_t(bytes[0]) << 8) | bytes[1];
+            for (std::size_t i = 2; i < size; ++i) {
+                trigram = ((trigram << 8) | bytes[i]) & 0xffffff;
+                trigrams.push_back(trigram);
+            }
+            std::sort(trigrams.begin(), trigrams.end());
+            trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        }
+
+        std::vector<const Document*> m_documents = {}; /**< The documents. */
+        Postings                     m_postings  = {}; /**< The posting list of each trigram. */
+    };
+
+    // ===== SPLITTING ALGORITHM
+
+    /**
+     * @brief Delimiter type for splitting container into sub-sequences delimited by a sequence of elements.
+     * @tparam ElemType The type of delimiter.
+     */
+    template<typename ElemType>
+    class ByElement
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking a delimiter as parameter.
+         * @param element The delimiter element.
+         */
+        constexpr explicit ByElement(const ElemType& element) : m_element(element) {}
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count) {
+                begin = detail::find(begin, end, m_element);
+                if (begin == end)
+                    break;
+                locations.emplace_back(begin++);
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            std::vector<RandomAccessIter> locations;
+            find_all_reverse(begin, end, std::back_inserter(locations), m_element, max_count);
+            return locations;
+        }
+
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the ByAnyElement type, the size of the delimiter is always one.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return 1;
+        }
+
+    private:
+        const ElemType& m_element; /**< The delimiter element. */
+    };
+
+    /**
+     * @brief Deduction guide for ByElement delimiter class.
+     */
+    template<typename T> ByElement(std::initializer_list<T>) -> ByElement<std::vector<T>>;
+
+    /**
+     * @brief Delimiter type for splitting container into sub-sequences delimited by a sequence of elements.
+     * @tparam SequenceType The type of delimiter sequence.
+     */
+    template<typename SequenceType>
+    class BySequence
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking a delimiter sequence as parameter.
+         * @param sequence The delimiter sequence.
+         */
+        constexpr explicit BySequence(const SequenceType& sequence) : m_sequence(sequence) {
+            static_assert(IsRandomAccessIterator<typename SequenceType::iterator>::value,
+                          "Delimiter is not a sequence container!");
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            std::vector<RandomAccessIter> locations;
+            if (m_sequence.empty())
+                return locations;
+
+            while (locations.size() < max_count) {
+                begin = detail::search(begin, end, m_sequence.begin(), m_sequence.end());
+                if (begin == end)
+                    break;
+                locations.emplace_back(begin);
+                std::advance(begin, length());
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            std::vector<RandomAccessIter> locations;
+            search_all_reverse(begin, end, m_sequence.begin(), m_sequence.end(), std::back_inserter(locations), max_count);
+            return locations;
+        }
+
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the BySequence type, the size of the delimiter is the length of the delimiter sequence.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return static_cast<int>(m_sequence.size());
+        }
+
+    private:
+        const SequenceType& m_sequence; /**< The delimiter sequence. */
+    };
+
+    /**
+     * @brief Deduction guide for BySequence delimiter class.
+     */
+    template<typename T> BySequence(std::initializer_list<T>) -> BySequence<std::vector<T>>;
+
+    /**
+     * @brief Delimiter type for splitting container into sub-sequences delimited by a literal which is fixed at compile
+     * time, e.g. trl::ByLiteral<'\r', '\n'>.
+     * @details The delimiters are found with a trl::LiteralSearcher, so no tables are built at runtime. With C++20,
+     * trl::ByString allows the literal to be given as a string. The elements of the container must be byte-sized.
+     * @tparam Chars The characters of the literal, which can not be empty.
+     */
+    template<char... Chars>
+    class ByLiteral
+    {
+    public:
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) const {
+
+            std::vector<RandomAccessIter> locations;
+            const LiteralSearcher<Chars...> searcher;
+            while (locations.size() < max_count) {
+                auto match = searcher(begin, end);
+                if (match.first == end)
+                    break;
+                locations.emplace_back(match.first);
+                begin = match.second;
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) const {
+
+            using ValueType = typename std::iterator_traits<RandomAccessIter>::value_type;
+            const ValueType literal[] = {detail::narrow<ValueType>(Chars)...};
+
+            std::vector<RandomAccessIter> locations;
+            search_all_reverse(begin, end, std::begin(literal), std::end(literal), std::back_inserter(locations), max_count);
+            return locations;
+        }
+
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the ByLiteral type, the size of the delimiter is the length of the literal.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return static_cast<int>(sizeof...(Chars));
+        }
+    };
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    /**
+     * @brief A trl::ByLiteral delimiter for a string literal given as a template argument (C++20), e.g.
+     * trl::ByString<"\r\n">.
      */
-    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
-    OutputIt find_all_not_of(ForwardIt1 first,
-                             ForwardIt1 last,
-                             ForwardIt2 s_first,
-                             ForwardIt2 s_last,
-                             OutputIt d_first) {
-        while (first != last) {
-            first = find_first_not_of(first, last, s_first, s_last);
-            if (first != last) {
-                *(d_first++) = first;
-                first++;
+    template<FixedString String>
+    using ByString = typename detail::ExpandString<String, ByLiteral>::type;
+#endif
+
+    /**
+     * @brief Delimiter type for splitting container into sequences delimited by any of given set of elements.
+     * @tparam SequenceType The type of delimiter sequence.
+     */
+    template<typename SequenceType>
+    class ByAnyElement
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking a sequence of delimiter elements as parameter.
+         * @param sequence The sequence of elements to use as delimiters.
+         */
+        constexpr explicit ByAnyElement(const SequenceType& sequence) : m_sequence(sequence) {
+            static_assert(IsRandomAccessIterator<typename SequenceType::iterator>::value,
+                          "Delimiter is not a sequence container!");
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count) {
+                begin = detail::find_first_of(begin, end, m_sequence.begin(), m_sequence.end());
+                if (begin == end)
+                    break;
+                locations.emplace_back(begin++);
             }
+
+            return locations;
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
 
-    // TODO(troldal): Implement trl::find_all_not_of with predicates
+            std::vector<RandomAccessIter> locations;
+            auto rfirst = std::make_reverse_iterator(end);
+            auto rlast  = std::make_reverse_iterator(begin);
+            while (locations.size() < max_count) {
+                rfirst = std::find_first_of(rfirst, rlast, m_sequence.begin(), m_sequence.end());
+                if (rfirst == rlast)
+                    break;
+                locations.emplace_back(std::prev((rfirst++).base()));
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the ByAnyElement type, the size of the delimiter is always one.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return 1;
+        }
+
+    private:
+        const SequenceType& m_sequence; /**< The sequence of delimiter elements. */
+    };
 
     /**
-     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range [first, last).
-     * @details This algorithm is a wrapper around the std::search algorithm. It simply calls std::search
-     * on the provided container, until all occurrences have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the sequence "HELLO" in a given string. It will find
-     * two items at position 2 and 9. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABHELLOAAHELLOBAX");
-     *      auto src = std::string("HELLO");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results));
-     *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the search range.
-     * @param s_last The last element in the search range.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
+     * @brief Deduction guide for ByAnyElement delimiter class.
      */
-    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt>
-    OutputIt search_all(ForwardIt1 first,
-                        ForwardIt1 last,
-                        ForwardIt2 s_first,
-                        ForwardIt2 s_last,
-                        OutputIt d_first) {
-        while (first != last) {
-            first = std::search(first, last, s_first, s_last);
-            if (first != last) {
-                *(d_first++) = first;
-                std::advance(first, std::distance(s_first, s_last));
+    template<typename T> ByAnyElement(std::initializer_list<T>) -> ByAnyElement<std::vector<T>>;
+
+    /**
+     * @brief Delimiter type for splitting container into sequences delimited by any of a set of elements which is fixed
+     * at compile time, e.g. trl::ByAnyOf<',', ';', '\t'>.
+     * @details The set is a trl::CharClass computed at compile time, so there is no container to search for each
+     * element. For contiguous sequences of bytes, small sets (up to four elements) are found by comparing 16 bytes at
+     * a time with each delimiter (with SSE2); larger sets use the vectorized table lookups of trl::CharClass. Elements
+     * are classified as by trl::CharClass, i.e. single byte elements are interpreted as unsigned char.
+     * @tparam Chars The delimiter elements, which can not be empty.
+     */
+    template<char... Chars>
+    class ByAnyOf
+    {
+        static_assert(sizeof...(Chars) > 0, "The ByAnyOf delimiter set can not be empty!");
+
+    public:
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) const {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count) {
+                if (detail::isConstantEvaluated())
+                    begin = detail::find_if(begin, end, Delimiters);
+                else
+                    begin = detail::lowerToPointers(begin, end, [](auto f, auto l) { return findFirst(f, l); });
+                if (begin == end)
+                    break;
+                locations.emplace_back(begin++);
             }
+
+            return locations;
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) const {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count) {
+                auto found = detail::lowerToPointers(begin, end, [](auto f, auto l) { return findLast(f, l); });
+                if (found == end)
+                    break;
+                locations.emplace_back(found);
+                end = found;
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the ByAnyOf type, the size of the delimiter is always one.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return 1;
+        }
+
+    private:
+
+        /**
+         * @brief Find the first delimiter in the range [first, last), or last if there is none.
+         */
+        template<typename Iter>
+        static Iter findFirst(Iter first, Iter last) {
+            if constexpr (std::is_pointer<Iter>::value &&
+                          detail::IsByteComparable<typename std::iterator_traits<Iter>::value_type>::value) {
+                const auto* bytes = detail::asBytes(first);
+                return first + (findFirstByte(bytes, bytes + (last - first)) - bytes);
+            }
+            else
+                return std::find_if(first, last, Delimiters);
+        }
+
+        /**
+         * @brief Find the last delimiter in the range [first, last), or last if there is none.
+         */
+        template<typename Iter>
+        static Iter findLast(Iter first, Iter last) {
+            if constexpr (std::is_pointer<Iter>::value &&
+                          detail::IsByteComparable<typename std::iterator_traits<Iter>::value_type>::value) {
+                const auto* bytes = detail::asBytes(first);
+                return first + (findLastByte(bytes, bytes + (last - first)) - bytes);
+            }
+            else {
+                for (auto it = last; it != first;)
+                    if (Delimiters(*--it))
+                        return it;
+                return last;
+            }
+        }
+
+        /**
+         * @brief Find the first delimiter in the byte range [first, last), or last if there is none.
+         */
+        static const unsigned char* findFirstByte(const unsigned char* first, const unsigned char* last) {
+            if constexpr (!UseEqualMask)
+                return detail::findClassByte(first, last, Delimiters, true);
+            else {
+#if TROLDALGO_HAS_SSE2
+                for (; last - first >= 16; first += 16) {
+                    const auto mask = equalMask16(first);
+                    if (mask != 0)
+                        return first + detail::countTrailingZeros(mask);
+                }
+#endif
+                for (; first != last; ++first)
+                    if (Delimiters.contains(*first))
+                        return first;
+                return last;
+            }
+        }
+
+        /**
+         * @brief Find the last delimiter in the byte range [first, last), or last if there is none.
+         */
+        static const unsigned char* findLastByte(const unsigned char* first, const unsigned char* last) {
+            if constexpr (!UseEqualMask)
+                return detail::findLastClassByte(first, last, Delimiters);
+            else {
+                auto* end = last;
+#if TROLDALGO_HAS_SSE2
+                for (; end - first >= 16; end -= 16) {
+                    const auto mask = equalMask16(end - 16);
+                    if (mask != 0)
+                        return end - 16 + detail::highestSetBit(mask);
+                }
+#endif
+                while (end != first)
+                    if (Delimiters.contains(*--end))
+                        return end;
+                return last;
+            }
+        }
+
+#if TROLDALGO_HAS_SSE2
+        /**
+         * @brief Compute a bitmask of the delimiters in the 16 bytes starting at ptr, by comparing with each delimiter.
+         */
+        static unsigned equalMask16(const unsigned char* ptr) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            __m128i       match = _mm_setzero_si128();
+            ((match = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Chars)))), ...);
+            return static_cast<unsigned>(_mm_movemask_epi8(match));
+        }
+#endif
+
+        /**
+         * @brief The delimiter set as a character class.
+         */
+        static constexpr CharClass Delimiters =
+            (CharClass::range(static_cast<unsigned char>(Chars), static_cast<unsigned char>(Chars)) | ...);
+
+        /**
+         * @brief Whether to compare with each delimiter, rather than using table lookups. Without SSSE3, the table
+         * lookups are scalar, so comparisons are used for larger sets as well.
+         */
+        static constexpr bool UseEqualMask = sizeof...(Chars) <= (TROLDALGO_HAS_SSSE3 ? 4 : 16);
+    };
 
     /**
-     * @brief Search for all non-overlapping occurrences of a sequence of values in a container, in the range [first, last), using a predicate.
-     * @details This algorithm is a wrapper around the std::search algorithm. It simply calls std::search
-     * on the provided container, until all occurrences have been found, or until the last element has been reached.
-     * #### Example
-     * The following example will find all occurrences of the sequence "HELLO" in a given string. It will find
-     * two items at position 2 and 9. Iterators to those elements will be copied to the results vector.
-     *   @code{.cpp}
-     *      auto str = std::string("ABHELLOAAHELLOBAX");
-     *      auto src = std::string("HELLO");
-     *      std::vector<decltype(str.begin())> results;
-            trl::find_all_of(str.begin(),str.end(), src.begin(), src.end(), std::back_inserter(results), [&](const char& a, const char& b) { return a == b; });
-     *   @endcode
-     * @tparam ForwardIt1 The type of the input iterator parameters. ForwardIt1 will be auto-deducted by the compiler.
-     * @tparam ForwardIt2 The type of the search iterator parameters. ForwardIt2 will be auto-deducted by the compiler.
-     * @tparam OutputIt The type of the output iterator of the output container. OutputIt will be auto-deducted by the compiler.
-     * @tparam BinaryPredicate A binary predicate which returns ​true if the elements should be treated as equal.
-     * @param first The first element in the range to examine.
-     * @param last One element beyond the last element in the range to examine.
-     * @param s_first The first element in the search range.
-     * @param s_last The last element in the search range.
-     * @param d_first An output iterator pointing to the first element to fill in the output container.
-     * @param p A binary predicate which returns ​true if the elements should be treated as equal.
-     * @return An output iterator pointing to one element beyond the last element of the output container.
-     * @throws Undefined find_all itself does not throw. However, std::find is not marked noexcept, so it might throw,
-     * but documentation does not reveal any details.
+     * @brief Delimiter type for splitting container at every element satisfying a predicate.
+     * @details The points are found with the same machinery as trl::find_all_if. Hence, if the predicate is a
+     * trl::CharClass, e.g. trl::CharClass::space(), contiguous sequences of bytes are classified using vectorized
+     * table lookups, rather than by calling the predicate for each element.
+     * @tparam UnaryPredicate The type of the predicate.
      */
-    template<typename ForwardIt1, typename ForwardIt2, typename OutputIt, typename BinaryPredicate>
-    OutputIt search_all(ForwardIt1 first,
-                        ForwardIt1 last,
-                        ForwardIt2 s_first,
-                        ForwardIt2 s_last,
-                        OutputIt d_first,
-                        BinaryPredicate p) {
-        while (first != last) {
-            first = std::search(first, last, s_first, s_last, p);
-            if (first != last) {
-                *(d_first++) = first;
-                std::advance(first, std::distance(s_first, s_last));
+    template<typename UnaryPredicate>
+    class ByPredicate
+    {
+    public:
+
+        /**
+         * @brief Constructor, taking the predicate as parameter.
+         * @param predicate A unary predicate which returns true for the delimiter elements.
+         */
+        constexpr explicit ByPredicate(UnaryPredicate predicate) : m_predicate(std::move(predicate)) {}
+
+        /**
+         * @brief Method for finding the points at which to split the container.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators one-past the place to split the container.
+         */
+        template<typename RandomAccessIter>
+        TROLDALGO_CONSTEXPR_VECTOR auto find(RandomAccessIter begin,
+                                             RandomAccessIter end,
+                                             std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count) {
+                begin = detail::find_if(begin, end, m_predicate);
+                if (begin == end)
+                    break;
+                locations.emplace_back(begin++);
             }
+
+            return locations;
         }
 
-        return d_first;
-    }
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            std::vector<RandomAccessIter> locations;
+            for (auto it = end; it != begin && locations.size() < max_count;)
+                if (m_predicate(*--it))
+                    locations.emplace_back(it);
+
+            return locations;
+        }
 
-    // TODO(troldal): Implement trl::search_all with option for using different searchers (see: https://en.cppreference.com/w/cpp/algorithm/search)
+        /**
+         * @brief Return the size of the delimiter.
+         * @return For the ByPredicate type, the size of the delimiter is always one.
+         */
+        [[nodiscard]] constexpr int length() const {
+            return 1;
+        }
 
-    // ===== SPLITTING ALGORITHM
+    private:
+        UnaryPredicate m_predicate; /**< The predicate identifying the delimiter elements. */
+    };
 
     /**
-     * @brief Delimiter type for splitting container into sub-sequences delimited by a sequence of elements.
-     * @tparam ElemType The type of delimiter.
+     * @brief Delimiter type for splitting container into sequences of a certain length length.
+     * @details The split points are computed directly from the size of the container, without examining any elements.
+     * The chunks can also be accessed without splitting (and copying) the container, using chunk_count and chunk, or
+     * trl::for_each_chunk, which can process the chunks in parallel.
      */
-    template<typename ElemType>
-    class ByElement
+    class ByLength
     {
     public:
 
         /**
-         * @brief Constructor, taking a delimiter as parameter.
-         * @param element The delimiter element.
+         * @brief Constructor, taking the sequence length as parameter.
+         * @param length Maximum length of sequences.
+         * @throws std::invalid_argument if the length is not positive.
          */
-        explicit ByElement(const ElemType& element) : m_element(element) {}
+        explicit ByLength(std::ptrdiff_t length) : m_length(length) {
+            if (m_length <= 0)
+                throw std::invalid_argument("The ByLength length must be positive.");
+        }
 
         /**
          * @brief Method for finding the points at which to split the container.
          * @tparam RandomAccessIter The type of container iterator.
          * @param begin The begin iterator.
          * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
          * @return A std::vector with iterators one-past the place to split the container.
          */
         template<typename RandomAccessIter>
         auto find(RandomAccessIter begin,
-                  RandomAccessIter end) {
+                  RandomAccessIter end,
+                  std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            // ===== The locations vector will store iterators to one-past each sequence to split off, i.e. to every
+            // ===== multiple of the length, except the end of the container.
+            std::vector<RandomAccessIter> locations;
+            const auto count = std::min(max_count, splitCount(std::distance(begin, end)));
+            locations.reserve(count);
+            for (std::size_t i = 1; i <= count; ++i)
+                locations.emplace_back(std::next(begin, static_cast<std::ptrdiff_t>(i) * m_length));
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end. The sequences
+         * are aligned with the end of the container, so that the first sequence may be shorter than the others.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
 
             std::vector<RandomAccessIter> locations;
-            find_all(begin, end, std::back_inserter(locations), m_element);
+            const auto count = std::min(max_count, splitCount(std::distance(begin, end)));
+            locations.reserve(count);
+            for (std::size_t i = 1; i <= count; ++i)
+                locations.emplace_back(std::prev(end, static_cast<std::ptrdiff_t>(i) * m_length));
+
             return locations;
         }
 
+        /**
+         * @brief Return the number of chunks of the range [begin, end), i.e. the size divided by the length, rounded
+         * up. An empty range has no chunks.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @return The number of chunks.
+         */
+        template<typename RandomAccessIter>
+        [[nodiscard]] std::size_t chunk_count(RandomAccessIter begin, RandomAccessIter end) const {
+            const auto size = std::distance(begin, end);
+            return size == 0 ? 0 : splitCount(size) + 1;
+        }
+
+        /**
+         * @brief Return the chunk with the given index, of the range [begin, end). All chunks have the given length,
+         * except the last one, which may be shorter.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param index The index of the chunk, which must be less than chunk_count(begin, end).
+         * @return A std::pair with iterators to the first element of the chunk, and one beyond the last element.
+         */
+        template<typename RandomAccessIter>
+        [[nodiscard]] std::pair<RandomAccessIter, RandomAccessIter> chunk(RandomAccessIter begin,
+                                                                          RandomAccessIter end,
+                                                                          std::size_t      index) const {
+            const auto offset = static_cast<std::ptrdiff_t>(index) * m_length;
+            const auto first  = std::next(begin, offset);
+            return {first, std::next(first, std::min(m_length, std::distance(first, end)))};
+        }
+
         /**
          * @brief Return the size of the delimiter.
-         * @return For the ByAnyElement type, the size of the delimiter is always one.
+         * @return For the ByLength type, the size of the delimiter is always zero.
          */
         [[nodiscard]] constexpr int length() const {
-            return 1;
+            return 0;
         }
 
     private:
-        const ElemType& m_element; /**< The delimiter element. */
+
+        /**
+         * @brief Return the number of split points of a range of the given size, i.e. the number of multiples of the
+         * length which are inside the range.
+         */
+        [[nodiscard]] std::size_t splitCount(std::ptrdiff_t size) const {
+            return size > m_length ? static_cast<std::size_t>((size - 1) / m_length) : 0;
+        }
+
+        const std::ptrdiff_t m_length; //*< The size of the sequence to separate. */
     };
 
     /**
-     * @brief Deduction guide for ByElement delimiter class.
+     * @brief Call a function for each chunk of a given length of the range [first, last), without copying the chunks.
+     * @details The chunks are computed directly from the size of the range, and the function is called with iterators
+     * to the first element of each chunk and one beyond its last element, in order. All chunks have the given length,
+     * except the last one, which may be shorter. The index of a chunk is (chunk_first - first) / length.
+     * #### Example
+     * The following example will compute a checksum of each 4 MB block of a buffer.
+     *   @code{.cpp}
+     *      std::vector<std::uint32_t> checksums;
+     *      trl::for_each_chunk(data.begin(), data.end(), trl::ByLength(4 << 20), [&](auto first, auto last) {
+     *          checksums.push_back(checksum(first, last));
+     *      });
+     *   @endcode
+     * @tparam RandomIt The type of the input iterators. RandomIt will be auto-deducted by the compiler.
+     * @tparam Function The type of the function. Function will be auto-deducted by the compiler.
+     * @param first The first element in the range to split into chunks.
+     * @param last One element beyond the last element in the range to split into chunks.
+     * @param chunking The length of the chunks.
+     * @param function The function to call for each chunk, with the iterators to the chunk.
+     * @return The function.
      */
-    template<typename T> ByElement(std::initializer_list<T>) -> ByElement<std::vector<T>>;
+    template<typename RandomIt, typename Function>
+    Function for_each_chunk(RandomIt first, RandomIt last, const ByLength& chunking, Function function) {
+        static_assert(IsRandomAccessIterator<RandomIt>::value, "for_each_chunk requires random access iterators!");
+
+        const auto count = chunking.chunk_count(first, last);
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto chunk = chunking.chunk(first, last, index);
+            function(chunk.first, chunk.second);
+        }
+
+        return function;
+    }
 
     /**
-     * @brief Delimiter type for splitting container into sub-sequences delimited by a sequence of elements.
-     * @tparam SequenceType The type of delimiter sequence.
+     * @brief Call a function for each chunk of a given length of the range [first, last), on a number of threads.
+     * @details The chunks are distributed evenly over the threads, as consecutive runs of chunks, and the function is
+     * called concurrently for chunks on different threads, so it must be safe to call concurrently. As the index of a
+     * chunk is (chunk_first - first) / length, the results can be stored by index, e.g. in a pre-sized vector, without
+     * any synchronization. If the function throws, the exception is rethrown after all threads have finished. Unless
+     * TROLDALGO_USE_THREADS is enabled, the chunks are processed on the calling thread.
+     * #### Example
+     * The following example will compute a checksum of each 4 MB block of a buffer, on eight threads.
+     *   @code{.cpp}
+     *      auto chunking  = trl::ByLength(4 << 20);
+     *      auto checksums = std::vector<std::uint32_t>(chunking.chunk_count(data.begin(), data.end()));
+     *      trl::for_each_chunk(data.begin(), data.end(), chunking, [&](auto first, auto last) {
+     *          checksums[std::size_t((first - data.begin()) / (4 << 20))] = checksum(first, last);
+     *      }, 8);
+     *   @endcode
+     * @tparam RandomIt The type of the input iterators. RandomIt will be auto-deducted by the compiler.
+     * @tparam Function The type of the function. Function will be auto-deducted by the compiler.
+     * @param first The first element in the range to split into chunks.
+     * @param last One element beyond the last element in the range to split into chunks.
+     * @param chunking The length of the chunks.
+     * @param function The function to call for each chunk, with the iterators to the chunk.
+     * @param threads The number of threads to use. The calling thread is one of them.
      */
-    template<typename SequenceType>
-    class BySequence
+    template<typename RandomIt, typename Function>
+    void for_each_chunk(RandomIt first, RandomIt last, const ByLength& chunking, Function function, std::size_t threads) {
+        static_assert(IsRandomAccessIterator<RandomIt>::value, "for_each_chunk requires random access iterators!");
+
+        detail::parallelFor(chunking.chunk_count(first, last), threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (auto index = begin; index < end; ++index) {
+                const auto chunk = chunking.chunk(first, last, index);
+                function(chunk.first, chunk.second);
+            }
+        });
+    }
+
+    /**
+     * @brief Delimiter type for splitting UTF-8 encoded text into chunks of at most a certain number of bytes, without
+     * splitting any multi-byte character.
+     * @details Each split point is found by moving the given number of bytes ahead, and then backing up over at most
+     * three continuation bytes. Hence, only the bytes around the split points are examined, and the cost is
+     * proportional to the number of chunks, rather than the size of the text. If a single character is longer than
+     * the maximum chunk size, the chunk will contain that character, so that each chunk holds at least one character.
+     * The text is not validated (use trl::is_valid_utf8 for that); if no lead byte is found within three bytes of a
+     * split point, as in malformed text, the text is split at the maximum chunk size anyway. Hence, no chunk is longer
+     * than the maximum chunk size, or four bytes, whichever is larger.
+     */
+    class ByUtf8Length
     {
     public:
 
         /**
-         * @brief Constructor, taking a delimiter sequence as parameter.
-         * @param sequence The delimiter sequence.
+         * @brief Constructor, taking the maximum chunk size (in bytes) as parameter.
+         * @param max_bytes Maximum number of bytes in each chunk.
+         * @throws std::invalid_argument if the maximum number of bytes is not positive.
          */
-        explicit BySequence(const SequenceType& sequence) : m_sequence(sequence) {
-            static_assert(IsRandomAccessIterator<typename SequenceType::iterator>::value,
-                          "Delimiter is not a sequence container!");
+        explicit ByUtf8Length(std::ptrdiff_t max_bytes) : m_maxBytes(max_bytes) {
+            if (m_maxBytes <= 0)
+                throw std::invalid_argument("The ByUtf8Length maximum number of bytes must be positive.");
         }
 
         /**
@@ -518,165 +6298,566 @@ namespace trl
          * @tparam RandomAccessIter The type of container iterator.
          * @param begin The begin iterator.
          * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
          * @return A std::vector with iterators one-past the place to split the container.
          */
         template<typename RandomAccessIter>
         auto find(RandomAccessIter begin,
-                  RandomAccessIter end) {
+                  RandomAccessIter end,
+                  std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
 
             std::vector<RandomAccessIter> locations;
-            search_all(begin, end, m_sequence.begin(), m_sequence.end(), std::back_inserter(locations));
+            while (locations.size() < max_count && std::distance(begin, end) > m_maxBytes) {
+                auto limit    = begin + m_maxBytes;
+                auto location = limit;
+                for (int i = 0; i < 3 && location != begin && isContinuation(*location); ++i)
+                    --location;
+                if (isContinuation(*location))
+                    location = limit;
+
+                // ===== The chunk must hold at least one character, even if it is longer than the maximum size.
+                if (location == begin) {
+                    location = std::next(begin);
+                    for (int i = 0; i < 3 && location != end && isContinuation(*location); ++i)
+                        ++location;
+                    if (location == end)
+                        break;
+                }
+
+                locations.emplace_back(location);
+                begin = location;
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end. The chunks
+         * are aligned with the end of the container, so that the first chunk may be shorter than the others.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            std::vector<RandomAccessIter> locations;
+            while (locations.size() < max_count && std::distance(begin, end) > m_maxBytes) {
+                auto limit    = end - m_maxBytes;
+                auto location = limit;
+                for (int i = 0; i < 3 && location != end && isContinuation(*location); ++i)
+                    ++location;
+                if (location != end && isContinuation(*location))
+                    location = limit;
+
+                // ===== The chunk must hold at least one character, even if it is longer than the maximum size.
+                if (location == end) {
+                    location = std::prev(end);
+                    for (int i = 0; i < 3 && location != begin && isContinuation(*location); ++i)
+                        --location;
+                    if (location == begin)
+                        break;
+                }
+
+                locations.emplace_back(location);
+                end = location;
+            }
+
             return locations;
         }
 
         /**
          * @brief Return the size of the delimiter.
-         * @return For the BySequence type, the size of the delimiter is the length of the delimiter sequence.
+         * @return For the ByUtf8Length type, the size of the delimiter is always zero.
          */
         [[nodiscard]] constexpr int length() const {
-            return static_cast<int>(m_sequence.size());
+            return 0;
         }
 
     private:
-        const SequenceType& m_sequence; /**< The delimiter sequence. */
-    };
 
-    /**
-     * @brief Deduction guide for BySequence delimiter class.
-     */
-    template<typename T> BySequence(std::initializer_list<T>) -> BySequence<std::vector<T>>;
+        /**
+         * @brief Determine if an element is a UTF-8 continuation byte.
+         */
+        template<typename T>
+        static bool isContinuation(const T& value) {
+            return detail::isUtf8Continuation(detail::narrow<unsigned char>(value));
+        }
+
+        const std::ptrdiff_t m_maxBytes; /**< The maximum number of bytes in each chunk. */
+    };
 
     /**
-     * @brief Delimiter type for splitting container into sequences delimited by any of given set of elements.
-     * @tparam SequenceType The type of delimiter sequence.
+     * @brief Delimiter type for splitting delimiter-separated values (e.g. CSV) into fields, respecting quoted fields.
+     * @details Delimiters inside quoted fields are not split on, as defined by RFC 4180. An escaped quote inside a
+     * quoted field is written as two quotes, so it does not change whether the following elements are inside quotes.
+     * The quotes are kept in the sub-containers, i.e. the fields are not unquoted.
+     *
+     * For contiguous sequences of bytes (e.g. std::string), the input is processed in blocks of 64 bytes, using
+     * bitmasks of the quotes and delimiters in the block. The bytes inside quotes are found by computing the prefix XOR
+     * of the quote bitmask, carrying the state over from the previous block. Only the delimiters outside quotes are
+     * then visited.
+     * @tparam ElemType The type of the delimiter and quote elements.
      */
-    template<typename SequenceType>
-    class ByAnyElement
+    template<typename ElemType>
+    class ByQuotedDelimiter
     {
     public:
 
         /**
-         * @brief Constructor, taking a sequence of delimiter elements as parameter.
-         * @param sequence The sequence of elements to use as delimiters.
+         * @brief Constructor, taking the delimiter and quote elements as parameters.
+         * @param delimiter The delimiter element, e.g. ','.
+         * @param quote The quote element. Defaults to '"'.
          */
-        explicit ByAnyElement(const SequenceType& sequence) : m_sequence(sequence) {
-            static_assert(IsRandomAccessIterator<typename SequenceType::iterator>::value,
-                          "Delimiter is not a sequence container!");
-        }
+        explicit ByQuotedDelimiter(const ElemType& delimiter, const ElemType& quote = '"')
+            : m_delimiter(delimiter),
+              m_quote(quote) {}
 
         /**
          * @brief Method for finding the points at which to split the container.
          * @tparam RandomAccessIter The type of container iterator.
          * @param begin The begin iterator.
          * @param end The end iterator.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
          * @return A std::vector with iterators one-past the place to split the container.
          */
         template<typename RandomAccessIter>
         auto find(RandomAccessIter begin,
-                  RandomAccessIter end) {
+                  RandomAccessIter end,
+                  std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            using ValueType = typename std::iterator_traits<RandomAccessIter>::value_type;
 
             std::vector<RandomAccessIter> locations;
-            find_all_of(begin, end, m_sequence.begin(), m_sequence.end(), std::back_inserter(locations));
+            if (begin == end || max_count == 0)
+                return locations;
+
+            if constexpr (IsContiguousIterator<RandomAccessIter>::value &&
+                          detail::IsByteComparable<ValueType>::value &&
+                          detail::IsByteComparable<ElemType>::value) {
+                if (detail::isRepresentable<ValueType>(m_delimiter) && detail::isRepresentable<ValueType>(m_quote)) {
+                    const auto* bytes     = detail::asBytes(std::addressof(*begin));
+                    const auto  delimiter = detail::narrow<unsigned char>(detail::narrow<ValueType>(m_delimiter));
+                    const auto  quote     = detail::narrow<unsigned char>(detail::narrow<ValueType>(m_quote));
+
+                    // ===== The carry is all ones if the previous block ended inside quotes.
+                    std::uint64_t carry = 0;
+                    detail::forEachBlock64(bytes, bytes + (end - begin), [&](const unsigned char* block,
+                                                                             const unsigned char* position,
+                                                                             std::uint64_t        valid) {
+                        const auto inside = detail::prefixXor(detail::equalMask64(block, quote)) ^ carry;
+                        carry             = std::uint64_t(0) - (inside >> 63);
+
+                        auto structural = detail::equalMask64(block, delimiter) & ~inside & valid;
+                        for (; structural != 0; structural &= structural - 1) {
+                            locations.emplace_back(begin + ((position - bytes) + detail::countTrailingZeros(structural)));
+                            if (locations.size() == max_count)
+                                return false;
+                        }
+                        return true;
+                    });
+
+                    return locations;
+                }
+            }
+
+            // ===== Generic case: toggle the quote state on each quote, and split on the delimiters outside quotes.
+            bool inside = false;
+            for (auto it = begin; it != end; ++it) {
+                if (*it == m_quote)
+                    inside = !inside;
+                else if (!inside && *it == m_delimiter) {
+                    locations.emplace_back(it);
+                    if (locations.size() == max_count)
+                        break;
+                }
+            }
+
+            return locations;
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @details As the quote state depends on the beginning of the container, the container is scanned from the
+         * beginning, and the last max_count points are returned.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            auto locations = find(begin, end);
+            if (locations.size() > max_count)
+                locations.erase(locations.begin(), std::prev(locations.end(), static_cast<std::ptrdiff_t>(max_count)));
+            std::reverse(locations.begin(), locations.end());
             return locations;
         }
 
         /**
          * @brief Return the size of the delimiter.
-         * @return For the ByAnyElement type, the size of the delimiter is always one.
+         * @return For the ByQuotedDelimiter type, the size of the delimiter is always one.
          */
         [[nodiscard]] constexpr int length() const {
             return 1;
         }
 
     private:
-        const SequenceType& m_sequence; /**< The sequence of delimiter elements. */
+        ElemType m_delimiter; /**< The delimiter element. */
+        ElemType m_quote;     /**< The quote element. */
     };
 
     /**
-     * @brief Deduction guide for ByAnyElement delimiter class.
-     */
-    template<typename T> ByAnyElement(std::initializer_list<T>) -> ByAnyElement<std::vector<T>>;
-
-    /**
-     * @brief Delimiter type for splitting container into sequences of a certain length length.
+     * @brief Delimiter type for splitting a container into lines.
+     * @details Both "\n" and "\r\n" are treated as a single line break, and optionally also a lone "\r" (as used by
+     * classic Mac OS text files). As the line breaks have different lengths, the length of each line break is given by
+     * the two-argument length member function.
+     *
+     * For contiguous sequences of bytes (e.g. std::string), the input is scanned in blocks of 64 bytes, using bitmasks
+     * of the newline candidates in each block.
      */
-    class ByLength
+    class ByLine
     {
     public:
 
         /**
-         * @brief Constructor, taking the sequence length as parameter.
-         * @param length Maximum length of sequences.
+         * @brief Constructor.
+         * @param split_on_cr If true, a lone '\r' is also treated as a line break. Defaults to false.
          */
-        explicit ByLength(std::ptrdiff_t length) : m_length(length) {}
+        explicit ByLine(bool split_on_cr = false) : m_splitOnCR(split_on_cr) {}
 
         /**
          * @brief Method for finding the points at which to split the container.
          * @tparam RandomAccessIter The type of container iterator.
          * @param begin The begin iterator.
          * @param end The end iterator.
-         * @return A std::vector with iterators one-past the place to split the container.
+         * @param max_count The maximum number of points to find. The search stops when it has been reached.
+         * @return A std::vector with iterators to the first element of each line break.
          */
         template<typename RandomAccessIter>
         auto find(RandomAccessIter begin,
-                  RandomAccessIter end) {
+                  RandomAccessIter end,
+                  std::size_t      max_count = std::numeric_limits<std::size_t>::max()) {
+
+            using ValueType = typename std::iterator_traits<RandomAccessIter>::value_type;
 
-            // ===== Iterate through the container to find the splitting locations.
-            // ===== The locations vector will store iterators to one-past each sequence to split off.
             std::vector<RandomAccessIter> locations;
-            while (std::distance(begin, end) > m_length) {
-                std::advance(begin, m_length);
-                locations.emplace_back(begin);
+            if (begin == end || max_count == 0)
+                return locations;
+
+            if constexpr (IsContiguousIterator<RandomAccessIter>::value && detail::IsByteComparable<ValueType>::value) {
+                const auto* bytes = detail::asBytes(std::addressof(*begin));
+                detail::forEachBlock64(bytes, bytes + (end - begin), [&](const unsigned char* block,
+                                                                         const unsigned char* position,
+                                                                         std::uint64_t        valid) {
+                    auto candidates = detail::equalMask64(block, '\n');
+                    if (m_splitOnCR)
+                        candidates |= detail::equalMask64(block, '\r');
+
+                    for (candidates &= valid; candidates != 0; candidates &= candidates - 1) {
+                        auto offset = (position - bytes) + detail::countTrailingZeros(candidates);
+                        if (bytes[offset] == '\n' && offset > 0 && bytes[offset - 1] == '\r') {
+                            if (m_splitOnCR)
+                                continue; // The line break has already been found at the '\r'.
+                            --offset;
+                        }
+                        locations.emplace_back(begin + offset);
+                        if (locations.size() == max_count)
+                            return false;
+                    }
+                    return true;
+                });
+
+                return locations;
+            }
+            else {
+                for (auto it = begin; it != end; ++it) {
+                    if (*it == '\n') {
+                        if (it != begin && *std::prev(it) == '\r') {
+                            if (m_splitOnCR)
+                                continue;
+                            locations.emplace_back(std::prev(it));
+                        }
+                        else
+                            locations.emplace_back(it);
+                    }
+                    else if (m_splitOnCR && *it == '\r')
+                        locations.emplace_back(it);
+                    else
+                        continue;
+
+                    if (locations.size() == max_count)
+                        break;
+                }
+
+                return locations;
+            }
+        }
+
+        /**
+         * @brief Method for finding the points at which to split the container, starting from the end.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param begin The begin iterator.
+         * @param end The end iterator.
+         * @param max_count The maximum number of points to find.
+         * @return A std::vector with iterators to the places to split the container, starting with the last one.
+         */
+        template<typename RandomAccessIter>
+        auto find_reverse(RandomAccessIter begin,
+                          RandomAccessIter end,
+                          std::size_t      max_count) {
+
+            std::vector<RandomAccessIter> locations;
+            for (auto it = end; it != begin && locations.size() < max_count;) {
+                // ===== Unless a lone '\r' is a line break, the backward search can skip directly to the next '\n'.
+                if (!m_splitOnCR) {
+                    auto found = detail::find_last(begin, it, '\n');
+                    if (found == it)
+                        break;
+                    it = std::next(found);
+                }
+
+                --it;
+                if (*it == '\n') {
+                    if (it != begin && *std::prev(it) == '\r')
+                        --it;
+                    locations.emplace_back(it);
+                }
+                else if (m_splitOnCR && *it == '\r')
+                    locations.emplace_back(it);
             }
 
             return locations;
         }
 
         /**
-         * @brief Return the size of the delimiter.
-         * @return For the ByLength type, the size of the delimiter is always zero.
+         * @brief Return the size of the line break at the given location.
+         * @tparam RandomAccessIter The type of container iterator.
+         * @param location Iterator to the first element of the line break.
+         * @param end The end iterator of the container.
+         * @return Two for "\r\n", otherwise one.
          */
-        [[nodiscard]] constexpr int length() const {
-            return 0;
+        template<typename RandomAccessIter>
+        [[nodiscard]] int length(RandomAccessIter location, RandomAccessIter end) const {
+            return (*location == '\r' && std::next(location) != end && *std::next(location) == '\n') ? 2 : 1;
         }
 
     private:
-        const std::ptrdiff_t m_length; //*< The size of the sequence to separate. */
+        bool m_splitOnCR; /**< Whether a lone '\r' is a line break. */
     };
 
+    namespace detail
+    {
+        /**
+         * @brief Determine if a delimiter type supports limiting the number of points found, i.e. if it has a find
+         * member function taking a maximum count as the third argument.
+         */
+        template<typename DelimiterType, typename Iter, typename = void>
+        struct HasLimitedFind : std::false_type {};
+
+        template<typename DelimiterType, typename Iter>
+        struct HasLimitedFind<DelimiterType,
+                              Iter,
+                              std::void_t<decltype(std::declval<DelimiterType&>().find(std::declval<Iter>(),
+                                                                                       std::declval<Iter>(),
+                                                                                       std::size_t()))>>
+                : std::true_type {};
+
+        /**
+         * @brief Determine if a delimiter type has variable length, i.e. if it has a length member function taking
+         * the location of the delimiter and the end of the container as arguments.
+         */
+        template<typename DelimiterType, typename Iter, typename = void>
+        struct HasVariableLength : std::false_type {};
+
+        template<typename DelimiterType, typename Iter>
+        struct HasVariableLength<DelimiterType,
+                                 Iter,
+                                 std::void_t<decltype(std::declval<DelimiterType&>().length(std::declval<Iter>(),
+                                                                                            std::declval<Iter>()))>>
+                : std::true_type {};
+
+        /**
+         * @brief Get the length of the delimiter at the given location.
+         */
+        template<typename DelimiterType, typename Iter>
+        constexpr auto delimiterLength(DelimiterType& delimiter, Iter location, Iter end) {
+            if constexpr (HasVariableLength<DelimiterType, Iter>::value)
+                return delimiter.length(location, end);
+            else
+                return delimiter.length();
+        }
+
+        /**
+         * @brief Split a container at the given (ascending) delimiter locations, and copy the sub-containers to the
+         * destination. The end() iterator of the container is added as the last location.
+         */
+        template<typename Container, typename Locations, typename OutputIt, typename DelimiterType>
+        void splitAt(Container&     container,
+                     Locations&     locations,
+                     OutputIt       destination,
+                     DelimiterType& delimiter) {
+
+            *std::back_inserter(locations) = container.end();
+
+            // ===== Iterate through the container and split at the given locations. Insert the elements in the destination container.
+            auto      first = container.begin();
+            for (auto last : locations) {
+                Container result; // TODO(troldal): This is ineffecient, but when creating Container in-place, the code won't compile.
+                std::copy(first, last, std::back_inserter(result));
+                *(destination++) = result;
+                auto length = (last == container.end()) ? 0 : delimiterLength(delimiter, last, container.end());
+                if (std::distance(last, container.end()) >= length)
+                    first = last + length;
+                else
+                    first = container.end();
+            }
+        }
+    }  // namespace detail
+
     /**
      * @brief Split a container into sub-containers, using a given delimiter
+     * @details If max_splits is given, the container is only split at the first max_splits delimiters, and the
+     * remainder of the container is copied to the destination as the final sub-container, without being examined.
+     * #### Example
+     * The following example will split a string at the first '=' only, giving "key" and "value=with=equals".
+     *   @code{.cpp}
+     *      auto str = std::string("key=value=with=equals");
+     *      std::vector<std::string> results;
+     *      trl::split(str, std::back_inserter(results), trl::ByElement('='), 1);
+     *   @endcode
      * @tparam Container The container type to be split. This will be auto-deduced by the compiler.
      * @tparam OutputIt The type of output iterator used for output of sub-containers. This will be auto-deduced by the compiler.
      * @tparam DelimiterType The type of delimiter. This will be auto-deduced by the compiler.
      * @param container The container to split.
      * @param destination An output iterator to the destination container.
      * @param delimiter The delimiter object to use.
+     * @param max_splits The maximum number of splits. By default, the container is split at every delimiter.
      */
     template<typename Container, typename OutputIt, typename DelimiterType>
     void split(Container container,
                OutputIt destination,
-               DelimiterType delimiter) {
+               DelimiterType delimiter,
+               std::size_t max_splits = std::numeric_limits<std::size_t>::max()) {
 
         // ===== Check that the container to be split is a sequential container, i.e. supports random access, eg. std::vector
         static_assert(IsRandomAccessIterator<typename Container::iterator>::value,
                       "Input container is not sequential!");
 
-        // ===== Find the locations where the sequence should be split. Add the end() iterator as the last element.
-        auto locations = delimiter.find(container.begin(), container.end());
-        *std::back_inserter(locations) = container.end();
-
-        // ===== Iterate through the container and split at the given locations. Insert the elements in the destination container.
-        auto      first = container.begin();
-        for (auto last : locations) {
-            Container result; // TODO(troldal): This is ineffecient, but when creating Container in-place, the code won't compile.
-            std::copy(first, last, std::back_inserter(result));
-            *(destination++) = result;
-            if (std::distance(last, container.end()) >= delimiter.length())
-                first = last + delimiter.length();
-            else
-                first = container.end();
+        // ===== Find the locations where the sequence should be split, and split the container at those locations.
+        // ===== If the delimiter can not stop the search after max_splits points, the excess points are discarded.
+        if constexpr (detail::HasLimitedFind<DelimiterType, typename Container::iterator>::value) {
+            auto locations = delimiter.find(container.begin(), container.end(), max_splits);
+            detail::splitAt(container, locations, destination, delimiter);
+        }
+        else {
+            auto locations = delimiter.find(container.begin(), container.end());
+            if (locations.size() > max_splits)
+                locations.erase(std::next(locations.begin(), static_cast<std::ptrdiff_t>(max_splits)), locations.end());
+            detail::splitAt(container, locations, destination, delimiter);
+        }
+    }
+
+    /**
+     * @brief Split a string view into sub-views, using a given delimiter.
+     * @details Unlike the general overload, no elements are copied: the sub-views refer to the characters of the
+     * string view. The destination can therefore be a fixed-capacity container, such as a std::array of string views,
+     * which holds at most max_splits + 1 sub-views. With C++20 (where std::vector, and hence the find member functions
+     * of the delimiter types, are constexpr), the string can be split at compile time, e.g. to build keyword tables.
+     * #### Example
+     * The following example will split a list of keywords at compile time.
+     *   @code{.cpp}
+     *      constexpr auto keywords = [] {
+     *          std::array<std::string_view, 3> result {};
+     *          trl::split(std::string_view("if,else,while"), result.begin(), trl::ByAnyOf<','>());
+     *          return result;
+     *      }();
+     *   @endcode
+     * @tparam CharT The character type of the string view. This will be auto-deduced by the compiler.
+     * @tparam Traits The character traits of the string view. This will be auto-deduced by the compiler.
+     * @tparam OutputIt The type of output iterator used for output of sub-views. This will be auto-deduced by the compiler.
+     * @tparam DelimiterType The type of delimiter. This will be auto-deduced by the compiler.
+     * @param str The string view to split.
+     * @param destination An output iterator to the destination container.
+     * @param delimiter The delimiter object to use.
+     * @param max_splits The maximum number of splits. By default, the string view is split at every delimiter.
+     * @return An output iterator pointing to one element beyond the last sub-view written.
+     */
+    template<typename CharT, typename Traits, typename OutputIt, typename DelimiterType>
+    TROLDALGO_CONSTEXPR_VECTOR OutputIt split(std::basic_string_view<CharT, Traits> str,
+                                              OutputIt destination,
+                                              DelimiterType delimiter,
+                                              std::size_t max_splits = std::numeric_limits<std::size_t>::max()) {
+
+        // ===== Find the locations where the string view should be split, as in the general overload.
+        auto locations = [&] {
+            if constexpr (detail::HasLimitedFind<DelimiterType, decltype(str.begin())>::value)
+                return delimiter.find(str.begin(), str.end(), max_splits);
+            else {
+                auto result = delimiter.find(str.begin(), str.end());
+                if (result.size() > max_splits)
+                    result.erase(std::next(result.begin(), static_cast<std::ptrdiff_t>(max_splits)), result.end());
+                return result;
+            }
+        }();
+
+        // ===== Write the sub-views between the locations to the destination.
+        std::size_t position = 0;
+        for (auto location : locations) {
+            const auto offset = static_cast<std::size_t>(location - str.begin());
+            *(destination++) = str.substr(position, offset - position);
+            position = std::min(offset + static_cast<std::size_t>(detail::delimiterLength(delimiter, location, str.end())),
+                                str.size());
         }
+        *(destination++) = str.substr(position);
+
+        return destination;
+    }
+
+    /**
+     * @brief Split a container into sub-containers, using a given delimiter, starting from the end.
+     * @details The container is split at the last max_splits delimiters only, which are found by scanning from the end
+     * of the container. The sub-containers are copied to the destination in their original order, so the first
+     * sub-container holds the remainder of the container, which has not been examined.
+     * #### Example
+     * The following example will split a path at the last '/', giving "usr/local" and "bin".
+     *   @code{.cpp}
+     *      auto str = std::string("usr/local/bin");
+     *      std::vector<std::string> results;
+     *      trl::rsplit(str, std::back_inserter(results), trl::ByElement('/'), 1);
+     *   @endcode
+     * @tparam Container The container type to be split. This will be auto-deduced by the compiler.
+     * @tparam OutputIt The type of output iterator used for output of sub-containers. This will be auto-deduced by the compiler.
+     * @tparam DelimiterType The type of delimiter. This will be auto-deduced by the compiler. The delimiter type must
+     * provide a find_reverse member function.
+     * @param container The container to split.
+     * @param destination An output iterator to the destination container.
+     * @param delimiter The delimiter object to use.
+     * @param max_splits The maximum number of splits. By default, the container is split at every delimiter.
+     */
+    template<typename Container, typename OutputIt, typename DelimiterType>
+    void rsplit(Container container,
+                OutputIt destination,
+                DelimiterType delimiter,
+                std::size_t max_splits = std::numeric_limits<std::size_t>::max()) {
+
+        // ===== Check that the container to be split is a sequential container, i.e. supports random access, eg. std::vector
+        static_assert(IsRandomAccessIterator<typename Container::iterator>::value,
+                      "Input container is not sequential!");
+
+        // ===== Find the locations where the sequence should be split, starting from the end. Reverse them, so that
+        // ===== the container can be split from the beginning.
+        auto locations = delimiter.find_reverse(container.begin(), container.end(), max_splits);
+        std::reverse(locations.begin(), locations.end());
+        detail::splitAt(container, locations, destination, delimiter);
     }
 }  // namespace trl
 
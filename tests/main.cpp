@@ -1,10 +1,33 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 
+#include "test_constexpr.hpp"
 #include "test_find_all.hpp"
+#include "test_find_all_grouped.hpp"
 #include "test_find_all_if.hpp"
 #include "test_find_all_if_not.hpp"
 #include "test_find_all_not_of.hpp"
 #include "test_find_all_of.hpp"
+#include "test_find_all_reverse.hpp"
 #include "test_find_first_not_of.hpp"
+#include "test_fm_index.hpp"
+#include "test_for_each_chunk.hpp"
+#include "test_icase.hpp"
+#include "test_literal_searcher.hpp"
+#include "test_posting_list_index.hpp"
 #include "test_search_all.hpp"
+#include "test_search_all_approx.hpp"
+#include "test_search_all_glob.hpp"
+#include "test_search_all_of.hpp"
+#include "test_search_all_regex.hpp"
+#include "test_search_all_reverse.hpp"
+#include "test_searcher_cache.hpp"
+#include "test_shift_or_searcher.hpp"
+#include "test_rsplit.hpp"
 #include "test_split.hpp"
+#include "test_split_any_of.hpp"
+#include "test_split_lines.hpp"
+#include "test_split_predicate.hpp"
+#include "test_split_quoted.hpp"
+#include "test_suffix_array_index.hpp"
+#include "test_trigram_index.hpp"
+#include "test_utf8.hpp"
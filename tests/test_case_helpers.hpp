@@ -5,6 +5,11 @@
 #ifndef ALGORITHMS_TEST_CASE_HELPERS_HPP
 #define ALGORITHMS_TEST_CASE_HELPERS_HPP
 
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
 
 template<typename T>
 struct CCaseDef1
@@ -367,4 +372,67 @@ inline auto create_split_cases() {
     return cases;
 }
 
+/*
+ * Create the corpora for testing the indices (trl::SuffixArrayIndex and trl::FmIndex): short texts with many
+ * repeats, texts containing zero bytes and bytes above 0x7f, and a longer random text.
+ */
+inline auto create_index_corpora() {
+
+    std::vector<std::string> corpora = {"banana", "mississippi", "ABHELLOAAHELLOBAX", "aaaaaaaaaaaaaaaa", "abababababab",
+                                        "x", std::string("\0a\0b\xff\x80\0a\0b\0", 11)};
+
+    std::mt19937 random(42);
+    std::string  text;
+    for (int i = 0; i < 4000; ++i)
+        text += "ab\0\xf0"[random() % 4] + std::string(random() % 5 == 0 ? "cab" : "");
+    corpora.push_back(text);
+
+    return corpora;
+}
+
+/*
+ * Create the needles for testing an index over a corpus: self-overlapping needles, needles at the start and end of
+ * the corpus, needles longer than any suffix, and needles with zero bytes and bytes above 0x7f.
+ */
+inline auto create_index_needles(const std::string& corpus) {
+
+    std::vector<std::string> needles = {"a", "ab", "aa", "aaa", "ana", "issi", "HELLO", "bab", "abcab", "b", corpus,
+                                        corpus + "a", "zzz", std::string("\0", 1), std::string("\0a", 2), "\xff\x80",
+                                        "\xf0\xf0"};
+    for (std::size_t length = 1; length < 8 && length <= corpus.size(); ++length) {
+        needles.push_back(corpus.substr(corpus.size() - length));
+        needles.push_back(corpus.substr(0, length));
+    }
+
+    return needles;
+}
+
+/*
+ * Check that searching an index over a container gives the same results as trl::search_all, and that counting gives
+ * the number of overlapping occurrences, for each of the needles. An empty needle must never be found.
+ */
+template<typename Index, typename Container>
+inline void check_index_searches(const Index& index, Container& container, const std::vector<std::string>& needles) {
+
+    for (const auto& string : needles) {
+        Container needle(string.begin(), string.end());
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> actual;
+        trl::search_all(container.begin(), container.end(), needle.begin(), needle.end(), std::back_inserter(expected));
+        index.search_all(needle.begin(), needle.end(), std::back_inserter(actual));
+        INFO(string);
+        REQUIRE(actual == expected);
+
+        std::size_t overlapping = 0;
+        for (auto it = container.begin(); (it = std::search(it, container.end(), needle.begin(), needle.end())) != container.end(); ++it)
+            ++overlapping;
+        REQUIRE(index.count(needle.begin(), needle.end()) == overlapping);
+    }
+
+    std::string empty;
+    std::vector<decltype(container.begin())> results;
+    index.search_all(empty.begin(), empty.end(), std::back_inserter(results));
+    REQUIRE(results.empty());
+}
+
 #endif //ALGORITHMS_TEST_CASE_HELPERS_HPP
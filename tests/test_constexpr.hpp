@@ -0,0 +1,135 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    constexpr std::string_view constexprText = "key=value; other=thing; last=one";
+
+    // ===== The algorithms can only be evaluated at compile time with compiler support.
+#if TROLDALGO_HAS_CONSTANT_EVALUATED
+
+    /*
+     * Run an algorithm writing up to N positions in constexprText to a fixed-capacity output, and return the number of
+     * positions found, followed by their offsets.
+     */
+    template<std::size_t N, typename Algorithm>
+    constexpr std::array<std::ptrdiff_t, N + 1> constexprOffsets(Algorithm algorithm) {
+        std::array<const char*, N> found {};
+        auto                       end = algorithm(found.begin());
+
+        std::array<std::ptrdiff_t, N + 1> result {};
+        result[0] = end - found.begin();
+        for (std::ptrdiff_t i = 0; i < result[0]; ++i)
+            result[std::size_t(i + 1)] = found[std::size_t(i)] - constexprText.begin();
+        return result;
+    }
+
+    constexpr auto constexprFindAll = constexprOffsets<4>([](auto d_first) {
+        return trl::find_all(constexprText.begin(), constexprText.end(), d_first, '=');
+    });
+
+    constexpr auto constexprFindAllIf = constexprOffsets<4>([](auto d_first) {
+        return trl::find_all_if(constexprText.begin(), constexprText.end(), d_first, trl::CharClass::space());
+    });
+
+    constexpr auto constexprFindAllOf = constexprOffsets<8>([](auto d_first) {
+        constexpr std::string_view delimiters = ";=";
+        return trl::find_all_of(constexprText.begin(), constexprText.end(), delimiters.begin(), delimiters.end(), d_first);
+    });
+
+    constexpr auto constexprFindAllNotOf = constexprOffsets<8>([](auto d_first) {
+        constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyz";
+        return trl::find_all_not_of(constexprText.begin(), constexprText.end(), letters.begin(), letters.end(), d_first);
+    });
+
+    constexpr auto constexprSearchAll = constexprOffsets<4>([](auto d_first) {
+        constexpr std::string_view needle = "; ";
+        return trl::search_all(constexprText.begin(), constexprText.end(), needle.begin(), needle.end(), d_first);
+    });
+
+    constexpr auto constexprSearchAllLiteral = constexprOffsets<4>([](auto d_first) {
+        return trl::search_all<'=', 'o'>(constexprText.begin(), constexprText.end(), d_first);
+    });
+
+    constexpr auto constexprFindFirstNotOf = [] {
+        constexpr std::string_view key = "KEY";
+        auto first = trl::find_first_not_of(constexprText.begin(), constexprText.end(), key.begin(), key.end(),
+                                             [](char a, char b) { return (a & ~0x20) == b; });
+        return first - constexprText.begin();
+    }();
+#endif
+}  // namespace
+
+#if TROLDALGO_HAS_CONSTANT_EVALUATED
+
+/*
+ * Test: constant evaluation of the algorithms
+ *
+ * Description: The algorithms are evaluated at compile time (the results are constexpr variables), with fixed-capacity
+ * output, and the results are checked with static assertions. The test is skipped if the compiler can not tell whether
+ * a function is being evaluated at compile time (TROLDALGO_HAS_CONSTANT_EVALUATED is 0).
+ */
+TEST_CASE("Evaluate the algorithms at compile time", "[constexpr]") {
+
+    STATIC_REQUIRE((constexprFindAll[0] == 3 && constexprFindAll[1] == 3 && constexprFindAll[2] == 16 &&
+                    constexprFindAll[3] == 28));
+    STATIC_REQUIRE((constexprFindAllIf[0] == 2 && constexprFindAllIf[1] == 10 && constexprFindAllIf[2] == 23));
+    STATIC_REQUIRE((constexprFindAllOf[0] == 5 && constexprFindAllOf[1] == 3 && constexprFindAllOf[2] == 9 &&
+                    constexprFindAllOf[3] == 16 && constexprFindAllOf[4] == 22 && constexprFindAllOf[5] == 28));
+    STATIC_REQUIRE((constexprFindAllNotOf[0] == 7 && constexprFindAllNotOf[1] == 3 && constexprFindAllNotOf[2] == 9 &&
+                    constexprFindAllNotOf[3] == 10 && constexprFindAllNotOf[7] == 28));
+    STATIC_REQUIRE((constexprSearchAll[0] == 2 && constexprSearchAll[1] == 9 && constexprSearchAll[2] == 22));
+    STATIC_REQUIRE((constexprSearchAllLiteral[0] == 1 && constexprSearchAllLiteral[1] == 28));
+    STATIC_REQUIRE(constexprFindFirstNotOf == 3);
+
+    // ===== The same algorithms give the same results at runtime.
+    std::string                         text(constexprText);
+    std::vector<decltype(text.begin())> results;
+    trl::find_all(text.begin(), text.end(), std::back_inserter(results), '=');
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[2] - text.begin() == constexprFindAll[3]);
+}
+#endif
+
+/*
+ * Test: trl::split of a std::string_view into sub-views.
+ *
+ * Description: The sub-views are compared with the sub-containers of the general overload. With C++20, the string view
+ * is also split at compile time, into a fixed-capacity std::array.
+ */
+TEST_CASE("Split a string view into sub-views", "[Split][constexpr]") {
+
+    std::string                   text(constexprText);
+    std::vector<std::string>      expected;
+    std::vector<std::string_view> results;
+    trl::split(text, std::back_inserter(expected), trl::ByAnyOf<';', '='>());
+    trl::split(constexprText, std::back_inserter(results), trl::ByAnyOf<';', '='>());
+    REQUIRE(std::vector<std::string>(results.begin(), results.end()) == expected);
+
+    expected.clear();
+    std::array<std::string_view, 3> fixed {};
+    trl::split(text, std::back_inserter(expected), trl::BySequence(std::string("; ")), 2);
+    REQUIRE(trl::split(constexprText, fixed.begin(), trl::ByLiteral<';', ' '>(), 2) == fixed.end());
+    REQUIRE(std::vector<std::string>(fixed.begin(), fixed.end()) == expected);
+
+#if TROLDALGO_HAS_CONSTANT_EVALUATED && defined(__cpp_lib_constexpr_vector)
+    constexpr auto keywords = [] {
+        std::array<std::string_view, 4> result {};
+        trl::split(std::string_view("if,else;while,for"), result.begin(), trl::ByAnyOf<',', ';'>());
+        return result;
+    }();
+    STATIC_REQUIRE((keywords[0] == "if" && keywords[1] == "else" && keywords[2] == "while" && keywords[3] == "for"));
+
+    constexpr auto lines = [] {
+        std::array<std::string_view, 3> result {};
+        constexpr std::string_view delimiter = "\r\n";
+        trl::split(std::string_view("GET /\r\nHost: x\r\n"), result.begin(), trl::BySequence(delimiter));
+        return result;
+    }();
+    STATIC_REQUIRE((lines[0] == "GET /" && lines[1] == "Host: x" && lines[2].empty()));
+#endif
+}
@@ -55,3 +55,95 @@ TEMPLATE_TEST_CASE("Find all elements matching a criterion in a collection of ch
         }
     }
 }
+
+/*
+ * Test: trl::find_all (container overload)
+ *
+ * Description: Test the behaviour of the container overload of the trl::find_all algorithm. For associative containers
+ * (std::multiset, std::unordered_multiset), the elements are looked up using equal_range; for all other containers,
+ * the result must be identical to the iterator version.
+ */
+TEMPLATE_TEST_CASE("Find all elements matching a criterion in a collection of characters using find_all on a container",
+                   "[find_all]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>),
+                   (std::multiset<char>),
+                   (std::unordered_multiset<char>)) {
+
+    // ===== Load test case definitions
+    auto cases = create_find_all_cases();
+
+    // ===== Iterate through the test cases
+    for (const auto& testcase : cases) {
+
+        // ===== Create container and populate it with data from the current case definition.
+        TestType container;
+        fill_char(container, testcase.array);
+        REQUIRE(container.size() == testcase.array.size());
+
+        // ===== Run tests for the current case definition
+        SECTION(testcase.case_title) {
+
+            // ===== Run the find_all algorithm on the container and on the iterators, and compare the results.
+            std::vector<decltype(container.begin())> results;
+            std::vector<decltype(container.begin())> expected;
+            trl::find_all(container, std::back_inserter(results), testcase.search_item);
+            trl::find_all(container.begin(), container.end(), std::back_inserter(expected), testcase.search_item);
+            REQUIRE(results.size() == testcase.item_locations.size());
+            REQUIRE(results == expected);
+
+            for (size_t it = 0; it < results.size(); ++it) {
+                REQUIRE(*results[it] == testcase.search_item);
+                REQUIRE(std::count(results.begin(), results.end(), results[it]) == 1);
+            }
+        }
+    }
+}
+
+/*
+ * Test: trl::find_all (contiguous memory)
+ *
+ * Description: Test the behaviour of the trl::find_all algorithm on contiguous memory (raw pointers, std::array and
+ * std::vector with integral elements), which is examined in blocks. The data is long enough to span several blocks,
+ * and searches for values that can not be represented by the element type are included.
+ */
+TEST_CASE("Find all elements in contiguous memory using find_all", "[find_all]") {
+
+    // ===== Create data spanning several blocks, with matches at the block boundaries.
+    std::vector<int> locations = {0, 63, 64, 127, 200, 255};
+    std::array<unsigned char, 256> data {};
+    for (auto loc : locations) data[static_cast<size_t>(loc)] = 0xFF;
+
+    SECTION("Raw pointers") {
+        std::vector<unsigned char*> results;
+        trl::find_all(data.data(), data.data() + data.size(), std::back_inserter(results), 0xFF);
+        REQUIRE(results.size() == locations.size());
+        for (size_t it = 0; it < results.size(); ++it)
+            REQUIRE(std::distance(data.data(), results[it]) == locations[it]);
+    }
+
+    SECTION("std::array iterators") {
+        std::vector<decltype(data.begin())> results;
+        trl::find_all(data.begin(), data.end(), std::back_inserter(results), static_cast<unsigned char>(0xFF));
+        REQUIRE(results.size() == locations.size());
+        for (size_t it = 0; it < results.size(); ++it)
+            REQUIRE(std::distance(data.begin(), results[it]) == locations[it]);
+    }
+
+    SECTION("Values that can not be represented by the element type") {
+        std::vector<decltype(data.begin())> results;
+        trl::find_all(data.begin(), data.end(), std::back_inserter(results), -1);
+        trl::find_all(data.begin(), data.end(), std::back_inserter(results), 0x1FF);
+        REQUIRE(results.empty());
+    }
+
+    SECTION("Wide integral elements") {
+        std::vector<long long> wide(data.begin(), data.end());
+        std::vector<decltype(wide.begin())> results;
+        trl::find_all(wide.begin(), wide.end(), std::back_inserter(results), 0xFF);
+        REQUIRE(results.size() == locations.size());
+        for (size_t it = 0; it < results.size(); ++it)
+            REQUIRE(std::distance(wide.begin(), results[it]) == locations[it]);
+    }
+}
@@ -0,0 +1,82 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <random>
+#include <iterator>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::find_all_grouped
+ *
+ * Description: Test finding the elements of each of a set of values in a single pass, compared with calling
+ * trl::find_all for each value. This includes values which are not found, duplicate values (which are only written
+ * to the first sink), zero bytes and bytes above 0x7f, values of a different type than the elements, and small
+ * and large sets (which use different kernels). The std::deque and std::list cases exercise the generic
+ * (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Find all elements of each of a set of values using find_all_grouped",
+                   "[find_all_grouped]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::vector<unsigned char>),
+                   (std::deque<char>),
+                   (std::list<char>)) {
+
+    std::mt19937 random(11);
+    std::string  str = "key,val,abc\n";
+    for (int i = 0; i < 3000; ++i)
+        str += static_cast<char>(random() % 4 == 0 ? random() % 256 : static_cast<unsigned char>("a,b;\n\t"[random() % 6]));
+    TestType container(str.begin(), str.end());
+
+    using Iterator = decltype(container.begin());
+    std::vector<int> values = {',', '\n', ';', 'Z', 0, 200, -56, ',', 'a'};
+
+    std::vector<std::vector<Iterator>>                         results(values.size());
+    std::vector<std::back_insert_iterator<std::vector<Iterator>>> sinks;
+    for (auto& result : results) sinks.push_back(std::back_inserter(result));
+
+    auto end = trl::find_all_grouped(container.begin(), container.end(), values.begin(), values.end(), sinks.begin());
+    REQUIRE(end == sinks.end());
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        std::vector<Iterator> expected;
+        if (std::find(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(i), values[i]) == values.begin() + static_cast<std::ptrdiff_t>(i))
+            trl::find_all(container.begin(), container.end(), std::back_inserter(expected), values[i]);
+        INFO(values[i]);
+        REQUIRE(results[i] == expected);
+    }
+
+    REQUIRE(std::distance(container.begin(), results[0][0]) == 3);
+    REQUIRE(std::distance(container.begin(), results[1][0]) == 11);
+    REQUIRE(results[7].empty());
+
+    // ===== Sets of up to four values, and more than 16 values, are found by comparing with each value and by table
+    // ===== lookups, respectively (with and without SSSE3).
+    std::vector<int> large = {'a', 'b', ';', '\t'};
+    for (int value = 14; value < 30; ++value) large.push_back(value);
+    for (const auto& set : {std::vector<int>{';', '\t'}, large}) {
+        std::vector<std::vector<Iterator>>                            found(set.size());
+        std::vector<std::back_insert_iterator<std::vector<Iterator>>> outputs;
+        for (auto& result : found) outputs.push_back(std::back_inserter(result));
+
+        trl::find_all_grouped(container.begin(), container.end(), set.begin(), set.end(), outputs.begin());
+        for (std::size_t i = 0; i < set.size(); ++i) {
+            std::vector<Iterator> expected;
+            trl::find_all(container.begin(), container.end(), std::back_inserter(expected), set[i]);
+            REQUIRE(found[i] == expected);
+        }
+    }
+
+    // ===== An empty range, and an empty set of values.
+    TestType empty;
+    std::vector<Iterator> none;
+    std::vector<std::back_insert_iterator<std::vector<Iterator>>> single {std::back_inserter(none)};
+    trl::find_all_grouped(empty.begin(), empty.end(), values.begin(), values.begin() + 1, single.begin());
+    trl::find_all_grouped(container.begin(), container.end(), values.begin(), values.begin(), single.begin());
+    REQUIRE(none.empty());
+}
@@ -0,0 +1,90 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <array>
+#include <list>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::find_all_reverse
+ *
+ * Description: Test the behaviour of the trl::find_all_reverse algorithm. The purpose of the find_all_reverse algorithm
+ * is to find all elements in a collection that has a certain value, starting from the end. Tests using std::string,
+ * std::vector, std::deque and std::list are included.
+ */
+TEMPLATE_TEST_CASE("Find all elements matching a criterion in a collection of characters using find_all_reverse",
+                   "[find_all_reverse]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>),
+                   (std::list<char>)) {
+
+    // ===== Load test case definitions
+    auto cases = create_find_all_cases();
+
+    // ===== Iterate through the test cases
+    for (const auto& testcase : cases) {
+
+        // ===== Create container and populate it with data from the current case definition.
+        TestType container;
+        fill_char(container, testcase.array);
+        REQUIRE(container.size() == testcase.array.size());
+
+        // ===== The elements are expected in reverse order.
+        auto locations = testcase.item_locations;
+        std::reverse(locations.begin(), locations.end());
+
+        // ===== Run tests for the current case definition
+        SECTION(testcase.case_title) {
+
+            // ===== Run the find_all_reverse algorithm and check that the number of found elements are correct.
+            std::vector<decltype(container.begin())> results;
+            trl::find_all_reverse(container.begin(), container.end(), std::back_inserter(results), testcase.search_item);
+            REQUIRE(results.size() == locations.size());
+
+            // ===== Check each found element that it has the right value and the right position.
+            for (size_t it = 0; it < results.size(); ++it) {
+                REQUIRE(std::distance(container.begin(), results[it]) == locations[it]);
+                REQUIRE(*results[it] == testcase.search_item);
+            }
+        }
+
+        // ===== Run tests for the current case definition
+        SECTION(testcase.case_title + " (Max Count)") {
+
+            // ===== Run the find_all_reverse algorithm, finding at most two elements.
+            std::vector<decltype(container.begin())> results;
+            trl::find_all_reverse(container.begin(), container.end(), std::back_inserter(results), testcase.search_item, 2);
+            REQUIRE(results.size() == std::min<size_t>(locations.size(), 2));
+
+            for (size_t it = 0; it < results.size(); ++it)
+                REQUIRE(std::distance(container.begin(), results[it]) == locations[it]);
+        }
+    }
+}
+
+/*
+ * Test: trl::find_all_reverse (contiguous memory)
+ *
+ * Description: Test the behaviour of the trl::find_all_reverse algorithm on contiguous memory, which is examined
+ * backwards in blocks. The data is long enough to span several blocks.
+ */
+TEMPLATE_TEST_CASE("Find all elements in contiguous memory using find_all_reverse",
+                   "[find_all_reverse]",
+                   (std::vector<char>),
+                   (std::vector<int>)) {
+
+    std::vector<int> locations = {255, 200, 127, 64, 63, 0};
+    TestType data(256, 0);
+    for (auto loc : locations) data[static_cast<size_t>(loc)] = 'A';
+
+    std::vector<decltype(data.begin())> results;
+    trl::find_all_reverse(data.begin(), data.end(), std::back_inserter(results), 'A');
+
+    REQUIRE(results.size() == locations.size());
+    for (size_t it = 0; it < results.size(); ++it)
+        REQUIRE(std::distance(data.begin(), results[it]) == locations[it]);
+}
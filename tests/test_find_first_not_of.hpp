@@ -36,6 +36,9 @@ TEMPLATE_TEST_CASE("Find first element NOT matching a criterion in a collection
 
         SECTION(testcase.case_title) {
             auto result = trl::find_first_not_of(container.begin(), container.end(), testcase.search_item.begin(), testcase.search_item.end());
+            auto resultPred = trl::find_first_not_of(container.begin(), container.end(), testcase.search_item.begin(), testcase.search_item.end(),
+                                                     [](char a, char b) { return a == b; });
+            REQUIRE(resultPred == result);
 
             if (testcase.item_locations.size() == 0)
                 REQUIRE(result == container.end());
@@ -0,0 +1,52 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::FmIndex
+ *
+ * Description: Test that counting and locating occurrences in an FM-index gives the same results as trl::search_all
+ * (and the number of overlapping occurrences), using the index corpora and needles shared with the SuffixArrayIndex
+ * tests, which include zero bytes (sharing the wavelet matrix value of the sentinel). Several sample rates are used,
+ * so that locating walks back over unsampled rows.
+ */
+TEMPLATE_TEST_CASE("Count and locate all occurrences of a sequence using an FmIndex",
+                   "[fm_index]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::vector<unsigned char>)) {
+
+    for (std::size_t sample_rate : std::initializer_list<std::size_t> {1, 4, 32}) {
+        for (const auto& corpus : create_index_corpora()) {
+            TestType container(corpus.begin(), corpus.end());
+            trl::FmIndex index(container.begin(), container.end(), sample_rate);
+            REQUIRE(index.size() == corpus.size());
+            check_index_searches(index, container, create_index_needles(corpus));
+        }
+    }
+}
+
+TEST_CASE("FmIndex of an empty range, and the size of the index", "[fm_index]") {
+
+    std::string corpus;
+    trl::FmIndex index(corpus.begin(), corpus.end());
+    std::string needle("\0", 1);
+    REQUIRE(index.count(needle.begin(), needle.end()) == 0);
+
+    REQUIRE_THROWS_AS(trl::FmIndex(corpus.begin(), corpus.end(), 0), std::invalid_argument);
+
+    // ===== The index is much smaller than a suffix array with an LCP array.
+    std::string text;
+    for (int i = 0; i < 100000; ++i) text += "user" + std::to_string(i % 97) + " ";
+    trl::FmIndex large(text.begin(), text.end());
+    REQUIRE(large.memory_usage() < 2 * text.size());
+    std::string user = "user42 ";
+    REQUIRE(large.count(user.begin(), user.end()) == 1031);
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <numeric>
+#include <initializer_list>
+#include <stdexcept>
+
+/*
+ * Test: trl::ByLength split points and chunks
+ *
+ * Description: The split points computed by trl::ByLength are compared with stepping through the container, for
+ * sizes around multiples of the length, with and without a maximum count. The chunks given by chunk_count and chunk
+ * must cover the container in order.
+ */
+TEMPLATE_TEST_CASE("Compute the chunks of a container using ByLength",
+                   "[ByLength][for_each_chunk]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    const std::ptrdiff_t length   = 5;
+    const auto           chunking = trl::ByLength(length);
+
+    for (std::ptrdiff_t size = 0; size < 23; ++size) {
+        TestType container(static_cast<std::size_t>(size), 'x');
+
+        // ===== The split points are at every multiple of the length inside the container.
+        std::vector<decltype(container.begin())> expected;
+        for (std::ptrdiff_t position = length; position < size; position += length)
+            expected.push_back(container.begin() + position);
+
+        REQUIRE(trl::ByLength(length).find(container.begin(), container.end()) == expected);
+        auto limited = trl::ByLength(length).find(container.begin(), container.end(), 2);
+        REQUIRE(limited.size() == std::min<std::size_t>(2, expected.size()));
+        REQUIRE(std::equal(limited.begin(), limited.end(), expected.begin()));
+
+        // ===== The chunks cover the container, and all but the last one have the given length.
+        const auto count = chunking.chunk_count(container.begin(), container.end());
+        REQUIRE(count == (size == 0 ? 0 : expected.size() + 1));
+
+        auto position = container.begin();
+        for (std::size_t index = 0; index < count; ++index) {
+            auto chunk = chunking.chunk(container.begin(), container.end(), index);
+            REQUIRE(chunk.first == position);
+            REQUIRE(chunk.second - chunk.first == std::min(length, container.end() - position));
+            position = chunk.second;
+        }
+        REQUIRE(position == container.end());
+    }
+
+    REQUIRE_THROWS_AS(trl::ByLength(0), std::invalid_argument);
+}
+
+/*
+ * Test: trl::for_each_chunk, sequentially and on several threads.
+ *
+ * Description: The chunks are summed, and the sums are stored by chunk index. The results on several threads must
+ * equal the sequential results, and exceptions thrown by the function must be rethrown.
+ */
+TEST_CASE("Process the chunks of a range using for_each_chunk", "[ByLength][for_each_chunk]") {
+
+    std::vector<int> data(1003);
+    std::iota(data.begin(), data.end(), 0);
+
+    const std::ptrdiff_t length   = 10;
+    const auto           chunking = trl::ByLength(length);
+    const auto           count    = chunking.chunk_count(data.begin(), data.end());
+    REQUIRE(count == 101);
+
+    std::vector<long> expected;
+    trl::for_each_chunk(data.begin(), data.end(), chunking, [&](auto first, auto last) {
+        REQUIRE(first - data.begin() == static_cast<std::ptrdiff_t>(expected.size()) * length);
+        expected.push_back(std::accumulate(first, last, 0L));
+    });
+    REQUIRE(expected.size() == count);
+    REQUIRE(std::accumulate(expected.begin(), expected.end(), 0L) == 1003L * 1002L / 2);
+
+    for (std::size_t threads : std::initializer_list<std::size_t> {1, 2, 4, 200}) {
+        std::vector<long> results(count);
+        trl::for_each_chunk(data.begin(), data.end(), chunking, [&](auto first, auto last) {
+            results[static_cast<std::size_t>((first - data.begin()) / length)] = std::accumulate(first, last, 0L);
+        }, threads);
+        REQUIRE(results == expected);
+    }
+
+    // ===== An empty range has no chunks, and exceptions are rethrown.
+    std::size_t calls = 0;
+    trl::for_each_chunk(data.end(), data.end(), chunking, [&](auto, auto) { ++calls; }, 4);
+    REQUIRE(calls == 0);
+    REQUIRE_THROWS_AS(trl::for_each_chunk(data.begin(), data.end(), chunking, [&](auto first, auto) {
+        if (*first == 500)
+            throw std::runtime_error("chunk");
+    }, 4), std::runtime_error);
+}
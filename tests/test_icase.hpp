@@ -0,0 +1,67 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::find_all_icase and trl::search_all_icase
+ *
+ * Description: Test the case-insensitive algorithms against the predicate overload of trl::search_all, using an
+ * input with letters of both cases, and the characters next to the letters in the ASCII table ('@', '[', '`' and
+ * '{'), which differ from letters only in bit 0x20. The input is long enough to exercise the vectorized kernels. The
+ * std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Find and search ignoring ASCII case",
+                   "[find_all_icase][search_all_icase]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    const std::string alphabet = "aAbBzZ@[`{09 .\xC1\xE1";
+    std::string str;
+    for (std::size_t i = 0; i < 500; ++i) str += alphabet[(i * 7 + i / 13) % alphabet.size()];
+    str += "ERROR error ErRoR";
+    TestType container(str.begin(), str.end());
+
+    auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c; };
+
+    // ===== Find all single values, including non-letters that differ from a letter in bit 0x20 only.
+    for (char value : {'a', 'Z', '@', '`', '[', '{', '0', '\xC1'}) {
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> results;
+        for (auto it = container.begin(); it != container.end(); ++it)
+            if (lower(*it) == lower(value))
+                expected.push_back(it);
+        trl::find_all_icase(container.begin(), container.end(), std::back_inserter(results), value);
+        REQUIRE(results == expected);
+    }
+
+    // ===== Search for sequences of different lengths.
+    for (std::string sequence : {"a", "Ab", "z@", "[`", "bZ{", "error", "ERROR ERROR", "aaaaaaaaaaaaaaaaaaaaaaaa"}) {
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> results;
+        trl::search_all(container.begin(), container.end(), sequence.begin(), sequence.end(),
+                        std::back_inserter(expected), [&](char a, char b) { return lower(a) == lower(b); });
+        trl::search_all_icase(container.begin(), container.end(), sequence.begin(), sequence.end(),
+                              std::back_inserter(results));
+        REQUIRE(results == expected);
+    }
+
+    // ===== The trailing "error" occurrences are found regardless of case.
+    std::string error = "Error";
+    std::vector<decltype(container.begin())> results;
+    trl::search_all_icase(container.begin(), container.end(), error.begin(), error.end(), std::back_inserter(results));
+    REQUIRE(results.size() >= 3);
+    REQUIRE(std::distance(container.begin(), results.back()) == static_cast<std::ptrdiff_t>(str.size() - 5));
+
+    // ===== An empty sequence is never found.
+    std::string empty;
+    results.clear();
+    trl::search_all_icase(container.begin(), container.end(), empty.begin(), empty.end(), std::back_inserter(results));
+    REQUIRE(results.empty());
+}
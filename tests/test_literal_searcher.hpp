@@ -0,0 +1,119 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all with a compile-time literal, trl::LiteralSearcher and trl::ByLiteral
+ *
+ * Description: Compare the compile-time literal forms with the default trl::search_all, for literals of various
+ * lengths. The text is long enough for the vectorized loop as well as the scalar tail to be exercised. The std::deque
+ * and std::list cases exercise the random access and the forward iterator code paths.
+ */
+TEMPLATE_TEST_CASE("Search for all occurrences of a compile-time literal",
+                   "[search_all][LiteralSearcher]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>),
+                   (std::list<char>)) {
+
+    std::string str;
+    for (std::size_t i = 0; i < 2000; ++i) str += "abcab\r\n"[(i * i + i / 7) % 7];
+    str += "abcabcabcabcabcabcabcabcabcabcab";
+    TestType container(str.begin(), str.end());
+
+    auto check = [&](const std::string& literal, auto searcher) {
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> results;
+        trl::search_all(container.begin(), container.end(), literal.begin(), literal.end(), std::back_inserter(expected));
+        trl::search_all(container.begin(), container.end(), searcher, std::back_inserter(results));
+        REQUIRE(results == expected);
+        return expected.size();
+    };
+
+    REQUIRE(check("\n", trl::LiteralSearcher<'\n'>()) > 0);
+    REQUIRE(check("\r\n", trl::LiteralSearcher<'\r', '\n'>()) > 0);
+    REQUIRE(check("abb", trl::LiteralSearcher<'a', 'b', 'b'>()) > 0);
+    REQUIRE(check("abcabcab", trl::LiteralSearcher<'a', 'b', 'c', 'a', 'b', 'c', 'a', 'b'>()) > 0);
+    REQUIRE(check("ccc", trl::LiteralSearcher<'c', 'c', 'c'>()) == 0);
+
+    // ===== The shorthand gives the same results.
+    std::vector<decltype(container.begin())> expected;
+    std::vector<decltype(container.begin())> results;
+    std::string literal = "\r\n";
+    trl::search_all(container.begin(), container.end(), literal.begin(), literal.end(), std::back_inserter(expected));
+    trl::search_all<'\r', '\n'>(container.begin(), container.end(), std::back_inserter(results));
+    REQUIRE(results == expected);
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    results.clear();
+    trl::search_all<"\r\n">(container.begin(), container.end(), std::back_inserter(results));
+    REQUIRE(results == expected);
+    REQUIRE(check("cabca", trl::StringSearcher<"cabca">()) > 0);
+#endif
+}
+
+/*
+ * Test: trl::LiteralSearcher with a literal at the very end of the text, and with bytes above 127.
+ */
+TEST_CASE("Search for a compile-time literal at the boundaries", "[search_all][LiteralSearcher]") {
+
+    for (std::size_t size = 0; size < 40; ++size) {
+        std::string str(size, 'x');
+        str += "\xff\xfeYZ";
+        std::vector<unsigned char> bytes(str.begin(), str.end());
+
+        auto match = trl::LiteralSearcher<'\xff', '\xfe', 'Y', 'Z'>()(str.begin(), str.end());
+        REQUIRE(match.first == str.begin() + static_cast<std::ptrdiff_t>(size));
+        REQUIRE(match.second == str.end());
+
+        auto byteMatch = trl::LiteralSearcher<'\xfe', 'Y'>()(bytes.begin(), bytes.end());
+        REQUIRE(byteMatch.first == bytes.begin() + static_cast<std::ptrdiff_t>(size) + 1);
+
+        auto noMatch = trl::LiteralSearcher<'Y', 'Z', 'x'>()(str.begin(), str.end());
+        REQUIRE(noMatch.first == str.end());
+    }
+}
+
+/*
+ * Test: trl::split and trl::rsplit with trl::ByLiteral, compared with trl::BySequence.
+ */
+TEMPLATE_TEST_CASE("Split a container using ByLiteral",
+                   "[Split ByLiteral]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str = "\r\nline one\r\nline two\r\n\r\nline three\r";
+    TestType    container(str.begin(), str.end());
+    TestType    delimiter = {'\r', '\n'};
+
+    std::vector<TestType> expected;
+    std::vector<TestType> results;
+    trl::split(container, std::back_inserter(expected), trl::BySequence(delimiter));
+    trl::split(container, std::back_inserter(results), trl::ByLiteral<'\r', '\n'>());
+    REQUIRE(expected.size() == 5);
+    REQUIRE(results == expected);
+
+    expected.clear();
+    results.clear();
+    trl::split(container, std::back_inserter(expected), trl::BySequence(delimiter), 2);
+    trl::split(container, std::back_inserter(results), trl::ByLiteral<'\r', '\n'>(), 2);
+    REQUIRE(results == expected);
+
+    expected.clear();
+    results.clear();
+    trl::rsplit(container, std::back_inserter(expected), trl::BySequence(delimiter), 2);
+    trl::rsplit(container, std::back_inserter(results), trl::ByLiteral<'\r', '\n'>(), 2);
+    REQUIRE(results == expected);
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    results.clear();
+    trl::rsplit(container, std::back_inserter(results), trl::ByString<"\r\n">(), 2);
+    REQUIRE(results == expected);
+#endif
+}
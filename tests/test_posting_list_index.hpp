@@ -0,0 +1,71 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::PostingListIndex
+ *
+ * Description: Test that querying the posting list index gives the same results as trl::find_all, for every byte
+ * value (including values not present, zero bytes, bytes above 0x7f, and values of a different type than the
+ * elements), and that the counts and posting lists are consistent. The std::deque case tests a non-contiguous range.
+ */
+TEMPLATE_TEST_CASE("Find all elements of each value using a PostingListIndex",
+                   "[posting_list_index]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::vector<unsigned char>),
+                   (std::deque<char>)) {
+
+    std::mt19937 random(3);
+    std::string  str = "ABCDDCBAABCDDCBAX";
+    for (int i = 0; i < 5000; ++i)
+        str += static_cast<char>(random() % 3 == 0 ? random() % 256 : 'a' + random() % 4);
+    TestType container(str.begin(), str.end());
+
+    trl::PostingListIndex index(container.begin(), container.end());
+    REQUIRE(index.size() == str.size());
+
+    std::size_t total = 0;
+    for (int value = -128; value < 256; ++value) {
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> actual;
+        trl::find_all(container.begin(), container.end(), std::back_inserter(expected), value);
+        index.find_all(std::back_inserter(actual), value);
+        INFO(value);
+        REQUIRE(actual == expected);
+        REQUIRE(index.count(value) == expected.size());
+        if (value >= 0) total += index.count(static_cast<unsigned char>(value));
+    }
+    REQUIRE(total == str.size());
+
+    // ===== Queries with the element type, and the posting lists.
+    std::vector<decltype(container.begin())> results;
+    index.find_all(std::back_inserter(results), 'X');
+    REQUIRE(results.size() >= 1);
+    REQUIRE(std::distance(container.begin(), results.front()) == 16);
+
+    const auto list = index.positions('A');
+    REQUIRE(std::vector<std::uint32_t>(list.first, list.first + 4) == std::vector<std::uint32_t>{0, 7, 8, 15});
+    REQUIRE(std::is_sorted(list.first, list.second));
+}
+
+TEST_CASE("PostingListIndex of an empty range, and of a range too long for the IndexType", "[posting_list_index]") {
+
+    std::string corpus;
+    trl::PostingListIndex index(corpus.begin(), corpus.end());
+    std::vector<std::string::iterator> results;
+    index.find_all(std::back_inserter(results), 'a');
+    REQUIRE(results.empty());
+    REQUIRE(index.count('a') == 0);
+
+    std::string large(300, 'a');
+    REQUIRE_THROWS_AS((trl::PostingListIndex<std::string::iterator, std::uint8_t>(large.begin(), large.end())),
+                      std::length_error);
+}
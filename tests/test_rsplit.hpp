@@ -0,0 +1,102 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <array>
+#include <set>
+#include <unordered_set>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::rsplit
+ *
+ * Description: Test the behaviour of the trl::rsplit algorithm. The purpose of the rsplit algorithm is to split a
+ * container at the last max_splits delimiters, found by scanning from the end, writing the sub-containers in their
+ * original order. The ByElement, BySequence, ByAnyElement and ByLength delimiters are tested, with and without a limit
+ * on the number of splits, using std::string, std::vector and std::deque.
+ */
+TEMPLATE_TEST_CASE("Split a container from the end using rsplit",
+                   "[rsplit]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit ByElement: All splits") {
+        TestType container = {';', 'H', 'E', 'L', 'L', 'O', ';', ';', 'H', 'I', ';'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::ByElement(';'));
+
+        REQUIRE(results.size() == 5);
+        REQUIRE(results[0].empty());
+        REQUIRE(results[1] == TestType{'H', 'E', 'L', 'L', 'O'});
+        REQUIRE(results[2].empty());
+        REQUIRE(results[3] == TestType{'H', 'I'});
+        REQUIRE(results[4].empty());
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit ByElement: Max splits") {
+        TestType container = {'A', ';', 'B', ';', 'C', ';', 'D'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::ByElement(';'), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'A', ';', 'B'});
+        REQUIRE(results[1] == TestType{'C'});
+        REQUIRE(results[2] == TestType{'D'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit BySequence: Max splits") {
+        TestType container = {'A', '#', '#', 'B', '#', '#', '#', 'C'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::BySequence(TestType{'#', '#'}), 1);
+
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == TestType{'A', '#', '#', 'B', '#'});
+        REQUIRE(results[1] == TestType{'C'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit ByAnyElement: Max splits") {
+        TestType container = {'A', ':', 'B', ',', 'C', '.', 'D'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::ByAnyElement(TestType{':', ',', '.'}), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'A', ':', 'B'});
+        REQUIRE(results[1] == TestType{'C'});
+        REQUIRE(results[2] == TestType{'D'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit ByLength: Aligned with the end") {
+        TestType container = {'H', 'E', 'L', 'L', 'O', 'W', 'O', 'R', 'L', 'D', 'X'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::ByLength(5));
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'H'});
+        REQUIRE(results[1] == TestType{'E', 'L', 'L', 'O', 'W'});
+        REQUIRE(results[2] == TestType{'O', 'R', 'L', 'D', 'X'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("rsplit ByElement: Zero splits") {
+        TestType container = {'A', ';', 'B'};
+
+        std::vector<TestType> results;
+        trl::rsplit(container, std::back_inserter(results), trl::ByElement(';'), 0);
+
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0] == container);
+    }
+}
@@ -84,3 +84,83 @@ TEMPLATE_TEST_CASE("Search for all sequences of elements in a collection of char
         }
     }
 }
+
+/*
+ * Test: trl::search_all (contiguous memory)
+ *
+ * Description: Test the behaviour of the trl::search_all algorithm on contiguous memory, where the haystack is longer
+ * than a single block and the matches straddle the block boundaries.
+ */
+TEMPLATE_TEST_CASE("Search for all sequences of elements in contiguous memory using search_all",
+                   "[search_all]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::vector<int>),
+                   (std::deque<char>)) {
+
+    // ===== Create a container with the sequence 'ABC' at the given locations.
+    std::vector<int> locations = {0, 62, 127, 300, 397};
+    TestType container(400, 'x');
+    for (auto loc : locations) {
+        auto pos = std::next(container.begin(), loc);
+        *pos = 'A';
+        *std::next(pos) = 'B';
+        *std::next(pos, 2) = 'C';
+    }
+
+    std::vector<decltype(container.begin())> results;
+    std::string sequence = "ABC";
+    trl::search_all(container.begin(), container.end(), sequence.begin(), sequence.end(), std::back_inserter(results));
+
+    REQUIRE(results.size() == locations.size());
+    for (size_t it = 0; it < results.size(); ++it)
+        REQUIRE(std::distance(container.begin(), results[it]) == locations[it]);
+}
+
+/*
+ * Test: trl::search_all (byte sequences)
+ *
+ * Description: Test the behaviour of the trl::search_all algorithm on contiguous byte sequences, which are searched
+ * using the C library byte functions. This includes sequences with a frequent first element, elements of different
+ * signedness, and empty sequences.
+ */
+TEST_CASE("Search for all byte sequences using search_all", "[search_all]") {
+
+    SECTION("Sequence with a frequent first element") {
+        std::string str(5000, 'A');
+        std::vector<int> locations = {17, 2500, 4997};
+        for (auto loc : locations) str[static_cast<size_t>(loc) + 2] = 'B';
+
+        std::string sequence = "AAB";
+        std::vector<decltype(str.begin())> results;
+        trl::search_all(str.begin(), str.end(), sequence.begin(), sequence.end(), std::back_inserter(results));
+
+        REQUIRE(results.size() == locations.size());
+        for (size_t it = 0; it < results.size(); ++it)
+            REQUIRE(std::distance(str.begin(), results[it]) == locations[it]);
+    }
+
+    SECTION("Elements of different signedness") {
+        std::vector<char> data = {'A', static_cast<char>(-1), 'B', 'A', static_cast<char>(-1), 'B'};
+        std::vector<unsigned char> unsignedSequence = {'A', 0xFF, 'B'};
+        std::vector<signed char> signedSequence = {'A', -1, 'B'};
+
+        std::vector<decltype(data.begin())> results;
+        trl::search_all(data.begin(), data.end(), unsignedSequence.begin(), unsignedSequence.end(),
+                        std::back_inserter(results));
+        REQUIRE(results.size() == static_cast<size_t>(std::is_signed<char>::value ? 0 : 2));
+
+        results.clear();
+        trl::search_all(data.begin(), data.end(), signedSequence.begin(), signedSequence.end(),
+                        std::back_inserter(results));
+        REQUIRE(results.size() == static_cast<size_t>(std::is_signed<char>::value ? 2 : 0));
+    }
+
+    SECTION("Empty sequence") {
+        std::string str = "HELLO";
+        std::string sequence;
+        std::vector<decltype(str.begin())> results;
+        trl::search_all(str.begin(), str.end(), sequence.begin(), sequence.end(), std::back_inserter(results));
+        REQUIRE(results.empty());
+    }
+}
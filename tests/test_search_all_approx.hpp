@@ -0,0 +1,124 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <initializer_list>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all_approx and trl::search_all_mismatch
+ *
+ * Description: Test approximate searches with a small, known example, and by comparing the bit-parallel kernels (used
+ * for sequences of bytes) with the generic kernels (used for sequences of ints) on a longer pseudo-random text.
+ * Sequences longer than 64 elements use the generic kernels for both.
+ */
+TEST_CASE("Search for approximate occurrences using search_all_approx", "[search_all_approx]") {
+
+    // ===== Known example
+    std::string str = "color colour kolor";
+    std::string src = "color";
+
+    std::vector<trl::ApproximateMatch<decltype(str.begin())>> results;
+    trl::search_all_approx(str.begin(), str.end(), src.begin(), src.end(), std::back_inserter(results), 1);
+
+    std::vector<std::pair<std::ptrdiff_t, std::size_t>> found;
+    for (auto& match : results) found.emplace_back(std::distance(str.begin(), match.last), match.distance);
+    REQUIRE(found == std::vector<std::pair<std::ptrdiff_t, std::size_t>>{{4, 1}, {5, 0}, {6, 1}, {10, 1}, {11, 1},
+                                                                         {12, 1}, {18, 1}});
+
+    // ===== An empty sequence is never found.
+    std::string empty;
+    results.clear();
+    trl::search_all_approx(str.begin(), str.end(), empty.begin(), empty.end(), std::back_inserter(results), 3);
+    REQUIRE(results.empty());
+
+    // ===== Compare the bit-parallel kernel (std::string) with the dynamic programming kernel (std::vector<int>).
+    std::string text;
+    for (std::size_t i = 0; i < 3000; ++i) text += "acgt"[(i * i * 7 + i / 3) % 4];
+    std::vector<int> values(text.begin(), text.end());
+
+    for (std::size_t length : std::initializer_list<std::size_t> {1, 5, 20, 64, 70}) {
+        auto pattern = text.substr(1234, length);
+        pattern[length / 2] = 'x';
+        std::vector<int> patternValues(pattern.begin(), pattern.end());
+
+        for (std::size_t distance : std::initializer_list<std::size_t> {0, 1, 3}) {
+            std::vector<trl::ApproximateMatch<decltype(text.begin())>>   bitParallel;
+            std::vector<trl::ApproximateMatch<decltype(values.begin())>> dynamic;
+            trl::search_all_approx(text.begin(), text.end(), pattern.begin(), pattern.end(),
+                                   std::back_inserter(bitParallel), distance);
+            trl::search_all_approx(values.begin(), values.end(), patternValues.begin(), patternValues.end(),
+                                   std::back_inserter(dynamic), distance);
+
+            REQUIRE(bitParallel.size() == dynamic.size());
+            for (std::size_t i = 0; i < bitParallel.size(); ++i) {
+                REQUIRE(std::distance(text.begin(), bitParallel[i].last) == std::distance(values.begin(), dynamic[i].last));
+                REQUIRE(bitParallel[i].distance == dynamic[i].distance);
+            }
+
+            // ===== The planted match with one substitution ends at the original position.
+            if (distance >= 1) {
+                auto planted = std::find_if(bitParallel.begin(), bitParallel.end(), [&](const auto& match) {
+                    return std::distance(text.begin(), match.last) == static_cast<std::ptrdiff_t>(1234 + length);
+                });
+                REQUIRE(planted != bitParallel.end());
+                REQUIRE(planted->distance <= 1);
+            }
+        }
+    }
+}
+
+/*
+ * Test: trl::search_all_mismatch
+ *
+ * Description: Test the k-mismatch search on a known example, and against a direct count of mismatches in each
+ * window. The std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Search for occurrences with mismatches using search_all_mismatch",
+                   "[search_all_mismatch]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    // ===== Known example
+    std::string str = "TAG-7 TAG-1 TAB-7";
+    std::string src = "TAG-7";
+    TestType container(str.begin(), str.end());
+
+    std::vector<trl::ApproximateMatch<decltype(container.begin())>> results;
+    trl::search_all_mismatch(container.begin(), container.end(), src.begin(), src.end(), std::back_inserter(results), 1);
+
+    std::vector<std::pair<std::ptrdiff_t, std::size_t>> found;
+    for (auto& match : results) found.emplace_back(std::distance(container.begin(), match.last), match.distance);
+    REQUIRE(found == std::vector<std::pair<std::ptrdiff_t, std::size_t>>{{5, 0}, {11, 1}, {17, 1}});
+
+    // ===== Compare with a direct count of the mismatches in each window, for sequences on both sides of 64 elements.
+    std::string text;
+    for (std::size_t i = 0; i < 2000; ++i) text += "ab"[(i * i + i / 5) % 2];
+    TestType textContainer(text.begin(), text.end());
+
+    for (std::size_t length : std::initializer_list<std::size_t> {1, 7, 64, 65}) {
+        auto pattern = text.substr(500, length);
+        for (std::size_t mismatches : std::initializer_list<std::size_t> {0, 2, 100}) {
+            std::vector<std::pair<std::ptrdiff_t, std::size_t>> expected;
+            for (std::size_t start = 0; start + length <= text.size(); ++start) {
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < length; ++i) count += std::size_t(text[start + i] != pattern[i]);
+                if (count <= mismatches)
+                    expected.emplace_back(static_cast<std::ptrdiff_t>(start + length), count);
+            }
+
+            std::vector<trl::ApproximateMatch<decltype(textContainer.begin())>> matches;
+            trl::search_all_mismatch(textContainer.begin(), textContainer.end(), pattern.begin(), pattern.end(),
+                                     std::back_inserter(matches), mismatches);
+
+            std::vector<std::pair<std::ptrdiff_t, std::size_t>> actual;
+            for (auto& match : matches) actual.emplace_back(std::distance(textContainer.begin(), match.last), match.distance);
+            REQUIRE(actual == expected);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all_glob
+ *
+ * Description: Test searching for glob patterns with '?' and '*' wildcards, including patterns with leading, trailing
+ * and repeated '*' wildcards, patterns consisting only of wildcards, and segments whose anchor occurs in positions
+ * where the rest of the segment does not match. The std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Search for all matches of a glob pattern using search_all_glob",
+                   "[search_all_glob]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str = "ERR: read timeout1, ERR: disk full, ERR: write timeout2; timeout3";
+    TestType container(str.begin(), str.end());
+
+    auto positions = [&](std::string pattern) {
+        std::vector<decltype(container.begin())> results;
+        trl::search_all_glob(container.begin(), container.end(), pattern.begin(), pattern.end(),
+                             std::back_inserter(results));
+
+        std::vector<std::ptrdiff_t> result;
+        for (auto it : results) result.push_back(std::distance(container.begin(), it));
+        return result;
+    };
+
+    // ===== Literal patterns and '?' wildcards.
+    REQUIRE(positions("ERR") == std::vector<std::ptrdiff_t>{0, 20, 36});
+    REQUIRE(positions("timeout?") == std::vector<std::ptrdiff_t>{10, 47, 57});
+    REQUIRE(positions("t?me??t") == std::vector<std::ptrdiff_t>{10, 47, 57});
+    REQUIRE(positions("?:") == std::vector<std::ptrdiff_t>{2, 22, 38});
+    REQUIRE(positions("???").size() == str.size() / 3);
+
+    // ===== '*' matches as few elements as possible, and the next match starts after the previous one.
+    REQUIRE(positions("ERR*timeout?") == std::vector<std::ptrdiff_t>{0, 20});
+    REQUIRE(positions("ERR*timeout3") == std::vector<std::ptrdiff_t>{0});
+    REQUIRE(positions("**ERR**?:*") == std::vector<std::ptrdiff_t>{0});
+    REQUIRE(positions("**ERR*?*") == std::vector<std::ptrdiff_t>{0, 20, 36});
+    REQUIRE(positions("ERR*full*timeout?") == std::vector<std::ptrdiff_t>{0});
+
+    // ===== Patterns which are not found.
+    REQUIRE(positions("ERR*timeout4").empty());
+    REQUIRE(positions("timeout3?").empty());
+    REQUIRE(positions("*").empty());
+    REQUIRE(positions("").empty());
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all_of and trl::TeddySearcher
+ *
+ * Description: Test searching for all occurrences of any of a set of literals, including literals sharing a prefix
+ * (where the longest match must be reported), literals shorter than the four byte fingerprint, more literals than
+ * buckets, and matches near the end of the range (which are found by the scalar tail). The results are compared with
+ * a naive search over a longer text, so that the vectorized blocks are exercised. The std::deque case exercises the
+ * generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Search for all occurrences of a set of literals using search_all_of",
+                   "[search_all_of]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str = "GET /a.js HTTP/1.1, POST /form, PUT /x, GET /, DELETE /item/7, PATCH /p, GETS /z, GE";
+    TestType container(str.begin(), str.end());
+
+    auto matches = [&](const std::vector<std::string>& literals) {
+        std::vector<decltype(container.begin())> results;
+        trl::search_all_of(container.begin(), container.end(), literals.begin(), literals.end(),
+                           std::back_inserter(results));
+
+        std::vector<std::ptrdiff_t> result;
+        for (auto it : results) result.push_back(std::distance(container.begin(), it));
+        return result;
+    };
+
+    // ===== HTTP verbs.
+    REQUIRE(matches({"GET", "POST", "PUT", "DELETE"}) == std::vector<std::ptrdiff_t>{0, 20, 32, 40, 47, 73});
+    REQUIRE(matches({"DELETE", "PATCH"}) == std::vector<std::ptrdiff_t>{47, 63});
+    REQUIRE(matches({"GE"}) == std::vector<std::ptrdiff_t>{0, 40, 73, 82});
+
+    // ===== Literals sharing a prefix: the longest one is matched, and matches do not overlap.
+    std::vector<decltype(container.begin())> results;
+    trl::TeddySearcher searcher({"G", "GET", "GETS", "ET"});
+    trl::search_all(container.begin(), container.end(), searcher, std::back_inserter(results));
+    std::vector<std::ptrdiff_t> lengths;
+    for (auto it : results) lengths.push_back(std::distance(it, searcher(it, container.end()).second));
+    REQUIRE(lengths == std::vector<std::ptrdiff_t>{3, 3, 2, 4, 1});
+
+    // ===== Single byte literals, empty literals, and literals which are not found.
+    REQUIRE(matches({",", "/"}).size() == 16);
+    REQUIRE(matches({"", "PUT"}) == std::vector<std::ptrdiff_t>{32});
+    REQUIRE(matches({"HEAD", "OPTIONS", "GETX"}).empty());
+    REQUIRE(matches({"GET /"}) == std::vector<std::ptrdiff_t>{0, 40});
+    REQUIRE(matches({}).empty());
+    REQUIRE(matches({""}).empty());
+}
+
+TEST_CASE("Compare search_all_of with a naive search", "[search_all_of]") {
+
+    std::string str;
+    for (int i = 0; i < 500; ++i)
+        str += std::to_string(i * 7919 % 1009) + (i % 5 == 0 ? " ERROR " : i % 3 == 0 ? " WARN " : " INFO ") +
+               "user" + std::to_string(i % 13) + (i % 11 == 0 ? " FATAL\n" : "\n");
+
+    std::vector<std::vector<std::string>> sets = {
+        {"ERROR", "WARN", "FATAL"},
+        {"user1", "user12", "ERR", "INFO user3"},
+        {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"},
+        {"user10\n", "user11\n", "user12\n", "1 ", "2 ", "\n9", "\n8", "AL\n", "OR u"}};
+
+    // ===== More literals than buckets.
+    std::vector<std::string> many;
+    for (int i = 100; i < 170; ++i) many.push_back(std::to_string(i));
+    sets.push_back(many);
+
+    // ===== Literals sharing a fingerprint, which all go in the same bucket.
+    sets.push_back({"user1", "user10", "user11", "user12", "user2", "user3", "user4", "user5", "user6", "ERROR"});
+
+    // ===== Literals which only differ in the fourth byte of the fingerprint.
+    sets.push_back({"INFO", "INFX", "WARN", "WARX", "ERRO"});
+
+    for (const auto& literals : sets) {
+        // ===== Leftmost-longest, non-overlapping matches.
+        std::vector<std::ptrdiff_t> expected;
+        for (std::size_t position = 0; position < str.size();) {
+            std::size_t length = 0;
+            for (const auto& literal : literals)
+                if (literal.size() > length && str.compare(position, literal.size(), literal) == 0)
+                    length = literal.size();
+            if (length == 0)
+                ++position;
+            else {
+                expected.push_back(static_cast<std::ptrdiff_t>(position));
+                position += length;
+            }
+        }
+
+        std::vector<std::string::iterator> results;
+        trl::search_all_of(str.begin(), str.end(), literals.begin(), literals.end(), std::back_inserter(results));
+        std::vector<std::ptrdiff_t> actual;
+        for (auto it : results) actual.push_back(it - str.begin());
+
+        REQUIRE(!expected.empty());
+        REQUIRE(actual == expected);
+    }
+
+    // ===== The literals may be given as any container of bytes.
+    std::vector<std::string_view> views = {"ERROR", "FATAL"};
+    std::vector<std::string::iterator> results;
+    trl::search_all_of(str.begin(), str.end(), views.begin(), views.end(), std::back_inserter(results));
+    REQUIRE(results.size() == 100 + 46);
+}
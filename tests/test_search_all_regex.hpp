@@ -0,0 +1,135 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <regex>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all_regex
+ *
+ * Description: Test searching for regular expressions with character classes, escapes, alternation and bounded and
+ * unbounded repetition, with leftmost-longest, non-overlapping matches. Plain string patterns exercise the literal
+ * fast path, and the std::deque case exercises the generic (non-contiguous) code path. The results are compared with
+ * std::regex (in POSIX extended mode, which is also leftmost-longest) on a longer text, and patterns which could
+ * make a naive search rescan the text from every match start are searched on a long text. Invalid patterns, patterns
+ * nested too deeply and patterns exceeding the state limit must throw.
+ */
+TEMPLATE_TEST_CASE("Search for all matches of a regular expression using search_all_regex",
+                   "[search_all_regex]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str = "ERROR404 WARN1234 INFO1 ERROR12 warn-5678, id=abc_42; x=0x1F\tcolor colour";
+    TestType container(str.begin(), str.end());
+
+    auto matches = [&](const std::string& pattern) {
+        std::vector<decltype(container.begin())> results;
+        trl::Regex regex(pattern);
+        trl::search_all_regex(container.begin(), container.end(), regex, std::back_inserter(results));
+
+        std::vector<std::string> result;
+        for (auto it : results) result.emplace_back(it, regex.match(it, container.end()));
+        return result;
+    };
+
+    // ===== Literals and classes.
+    REQUIRE(matches("ERROR") == std::vector<std::string>{"ERROR", "ERROR"});
+    REQUIRE(matches("[0-9]+") == std::vector<std::string>{"404", "1234", "1", "12", "5678", "42", "0", "1"});
+    REQUIRE(matches("\\d\\d\\d\\d") == std::vector<std::string>{"1234", "5678"});
+    REQUIRE(matches("[A-Z]+[0-9]+") == std::vector<std::string>{"ERROR404", "WARN1234", "INFO1", "ERROR12"});
+    REQUIRE(matches("[^ ,;\\t]+=\\w+") == std::vector<std::string>{"id=abc_42", "x=0x1F"});
+    REQUIRE(matches("\\s") == std::vector<std::string>{" ", " ", " ", " ", " ", " ", "\t", " "});
+
+    // ===== Alternation, grouping and repetition.
+    REQUIRE(matches("(ERROR|WARN)[0-9]{3,4}") == std::vector<std::string>{"ERROR404", "WARN1234"});
+    REQUIRE(matches("(ERROR|WARN|warn-)\\d{2,}") == std::vector<std::string>{"ERROR404", "WARN1234", "ERROR12", "warn-5678"});
+    REQUIRE(matches("colou?r") == std::vector<std::string>{"color", "colour"});
+    REQUIRE(matches("(ab|a)(c|bcd)?_") == std::vector<std::string>{"abc_"});
+    REQUIRE(matches("[a-z]{2}") == std::vector<std::string>{"wa", "rn", "id", "ab", "co", "lo", "co", "lo", "ur"});
+    REQUIRE(matches("o.") == std::vector<std::string>{"ol", "or", "ol", "ou"});
+    REQUIRE(matches("l?o") == std::vector<std::string>{"o", "lo", "o", "lo"});
+
+    // ===== Empty matches are not reported, and patterns which are not found.
+    REQUIRE(matches("x*") == std::vector<std::string>{"x", "x"});
+    REQUIRE(matches("(a|b)?") == std::vector<std::string>{"a", "a", "b"});
+    REQUIRE(matches("ERROR4040").empty());
+    REQUIRE(matches("\\d{5}").empty());
+}
+
+TEST_CASE("Compare search_all_regex with std::regex", "[search_all_regex]") {
+
+    std::string str;
+    for (int i = 0; i < 200; ++i)
+        str += "user" + std::to_string(i * 37 % 101) + "@host" + std::to_string(i % 7) + ".example.org; " +
+               (i % 3 == 0 ? "GET /index.html 200\n" : "POST /api/v" + std::to_string(i % 4) + " 404\n");
+
+    for (std::string pattern : {"[a-z]+[0-9]+@host[0-6]\\.example\\.org",
+                                "(GET|POST) /[a-z]+",
+                                "[0-9]{3}\n",
+                                "(a|ab)(c|bcd)?(d*)",
+                                "\\.[a-z]+",
+                                "e[a-z]*e",
+                                "user9[0-9]?@"}) {
+        std::vector<std::string::iterator> results;
+        trl::Regex regex(pattern);
+        trl::search_all_regex(str.begin(), str.end(), regex, std::back_inserter(results));
+
+        std::vector<std::string> expected;
+        std::vector<std::string> actual;
+        std::regex reference(pattern, std::regex::extended);
+        for (auto it = std::sregex_iterator(str.begin(), str.end(), reference); it != std::sregex_iterator(); ++it)
+            if (it->length() > 0) expected.push_back(it->str());
+        for (auto it : results) actual.emplace_back(it, regex.match(it, str.end()));
+
+        INFO(pattern);
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("search_all_regex does not rescan the range from every match start", "[search_all_regex]") {
+
+    // ===== From every 'a', the automaton for "a+b|a" runs on to the end of the range looking for a 'b'; rescanning
+    // ===== from each match start would take quadratic time.
+    const std::size_t length = 200000;
+    std::string       str(length, 'a');
+
+    std::vector<std::string::iterator> results;
+    trl::search_all_regex(str.begin(), str.end(), trl::Regex("a+b|a"), std::back_inserter(results));
+    REQUIRE(results.size() == length);
+    REQUIRE(results.back() == str.end() - 1);
+
+    results.clear();
+    trl::search_all_regex(str.begin(), str.end(), trl::Regex("(aa)+b|a{3}"), std::back_inserter(results));
+    REQUIRE(results.size() == length / 3);
+    REQUIRE(results.back() == str.begin() + 3 * (length / 3 - 1));
+
+    str.back() = 'b';
+    results.clear();
+    trl::search_all_regex(str.begin(), str.end(), trl::Regex("a+b|a"), std::back_inserter(results));
+    REQUIRE(results == std::vector<std::string::iterator>{str.begin()});
+}
+
+TEST_CASE("Invalid regular expressions throw", "[search_all_regex]") {
+
+    for (std::string pattern : {"(abc", "abc)", "[abc", "a{3", "a{3,2}", "*a", "a|+", "^abc", "abc$", "\\q", "a\\"})
+        REQUIRE_THROWS_AS(trl::Regex(pattern), std::invalid_argument);
+
+    // ===== Deeply nested patterns are rejected, rather than overflowing the stack.
+    REQUIRE_NOTHROW(trl::Regex(std::string(1000, '(') + "a" + std::string(1000, ')')));
+    REQUIRE_THROWS_AS(trl::Regex(std::string(200000, '(')), std::invalid_argument);
+    REQUIRE_THROWS_AS(trl::Regex(std::string(1001, '(') + "a" + std::string(1001, ')')), std::invalid_argument);
+    REQUIRE_THROWS_AS(trl::Regex("a" + std::string(200000, '?')), std::invalid_argument);
+    std::string nested = "a";
+    for (int i = 0; i < 400; ++i) nested = "(" + nested + "?+?)";
+    REQUIRE_THROWS_AS(trl::Regex(nested), std::invalid_argument);
+
+    // ===== The number of states grows exponentially in n for (a|b)*a(a|b){n}.
+    REQUIRE_NOTHROW(trl::Regex("(a|b)*a(a|b){5}"));
+    REQUIRE_THROWS_AS(trl::Regex("(a|b)*a(a|b){20}", 1000), std::length_error);
+}
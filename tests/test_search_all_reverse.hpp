@@ -0,0 +1,83 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <array>
+#include <list>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all_reverse
+ *
+ * Description: Test the behaviour of the trl::search_all_reverse algorithm. The purpose of the search_all_reverse
+ * algorithm is to find all non-overlapping sequences in a collection, starting from the end. Tests using std::string,
+ * std::vector, std::deque and std::list are included.
+ */
+TEMPLATE_TEST_CASE("Search for all sequences of elements in a collection of characters using search_all_reverse",
+                   "[search_all_reverse]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>),
+                   (std::list<char>)) {
+
+    // ===== Load test case definitions
+    auto cases = create_search_all_cases();
+
+    // ===== Iterate through the test cases
+    for (auto testcase : cases) {
+
+        // ===== Create container and populate it with data from the current case definition.
+        TestType container;
+        fill_char(container, testcase.array);
+        REQUIRE(container.size() == testcase.array.size());
+
+        // ===== The occurrences are expected in reverse order.
+        auto locations = testcase.item_locations;
+        std::reverse(locations.begin(), locations.end());
+
+        // ===== Run tests for the current case definition
+        SECTION(testcase.case_title) {
+
+            // ===== Run the search_all_reverse algorithm and check that the number of found elements are correct.
+            std::vector<decltype(container.begin())> results;
+            trl::search_all_reverse(container.begin(), container.end(), testcase.search_item.begin(),
+                                    testcase.search_item.end(), std::back_inserter(results));
+            REQUIRE(results.size() == locations.size());
+
+            for (size_t it = 0; it < results.size(); ++it)
+                REQUIRE(std::distance(container.begin(), results[it]) == locations[it]);
+        }
+
+        // ===== Run tests for the current case definition
+        SECTION(testcase.case_title + " (Max Count)") {
+
+            // ===== Run the search_all_reverse algorithm, finding at most one occurrence.
+            std::vector<decltype(container.begin())> results;
+            trl::search_all_reverse(container.begin(), container.end(), testcase.search_item.begin(),
+                                    testcase.search_item.end(), std::back_inserter(results), 1);
+            REQUIRE(results.size() == std::min<size_t>(locations.size(), 1));
+
+            for (size_t it = 0; it < results.size(); ++it)
+                REQUIRE(std::distance(container.begin(), results[it]) == locations[it]);
+        }
+    }
+}
+
+/*
+ * Test: trl::search_all_reverse (overlapping sequences)
+ *
+ * Description: Test that the occurrences found by trl::search_all_reverse are non-overlapping from the end.
+ */
+TEST_CASE("Search for self-overlapping sequences using search_all_reverse", "[search_all_reverse]") {
+
+    std::string str = "AAAAA";
+    std::string sequence = "AA";
+    std::vector<decltype(str.begin())> results;
+    trl::search_all_reverse(str.begin(), str.end(), sequence.begin(), sequence.end(), std::back_inserter(results));
+
+    REQUIRE(results.size() == 2);
+    REQUIRE(std::distance(str.begin(), results[0]) == 3);
+    REQUIRE(std::distance(str.begin(), results[1]) == 1);
+}
@@ -0,0 +1,133 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::SearcherCache
+ *
+ * Description: Test that cached searchers give the same results as trl::search_all with the needle, that repeated
+ * lookups hit the cache, that the least recently used searchers are evicted when the capacity is exceeded (using a
+ * single shard, so the order is deterministic), that the capacity bounds the total number of searchers regardless
+ * of how the needles hash to the shards, that evicted searchers remain usable while referenced, and that concurrent
+ * lookups from several threads are counted correctly. Standard library searchers, trl::ShiftOrSearcher and
+ * trl::TeddySearcher (with a custom factory) are cached.
+ */
+TEST_CASE("Reuse compiled searchers using a SearcherCache", "[searcher_cache]") {
+
+    std::string str = "ABHELLOAAHELLOBAX ERROR404 WARN1234";
+
+    auto search = [&](const auto& searcher) {
+        std::vector<std::string::iterator> results;
+        trl::search_all(str.begin(), str.end(), searcher, std::back_inserter(results));
+        return results;
+    };
+
+    SECTION("Standard library and trl searchers") {
+        trl::SearcherCache<std::boyer_moore_horspool_searcher<std::string::const_iterator>> horspool(64);
+        trl::SearcherCache<trl::ShiftOrSearcher<std::string::const_iterator>>              shiftOr(64);
+
+        for (int round = 0; round < 3; ++round) {
+            for (std::string needle : {"HELLO", "A", "AX", "ERROR", "MISSING"}) {
+                std::vector<std::string::iterator> expected;
+                trl::search_all(str.begin(), str.end(), needle.begin(), needle.end(), std::back_inserter(expected));
+                REQUIRE(search(*horspool.get(needle)) == expected);
+                REQUIRE(search(*shiftOr.get(needle)) == expected);
+            }
+        }
+
+        const auto statistics = horspool.statistics();
+        REQUIRE(statistics.misses == 5);
+        REQUIRE(statistics.hits == 10);
+        REQUIRE(statistics.evictions == 0);
+        REQUIRE(horspool.size() == 5);
+
+        horspool.clear();
+        REQUIRE(horspool.size() == 0);
+        REQUIRE(search(*horspool.get("HELLO")).size() == 2);
+        REQUIRE(horspool.statistics().misses == 6);
+    }
+
+    SECTION("Custom factory") {
+        // ===== A TeddySearcher for a comma separated list of literals.
+        auto factory = [](const std::string& needle) {
+            if (needle.empty()) throw std::invalid_argument("No literals");
+            std::vector<std::string> literals;
+            trl::split(needle, std::back_inserter(literals), trl::ByElement(','));
+            return trl::TeddySearcher(literals.begin(), literals.end());
+        };
+
+        trl::SearcherCache<trl::TeddySearcher> teddy(8, 4, factory);
+        REQUIRE(search(*teddy.get("ERROR,WARN")).size() == 2);
+        REQUIRE(search(*teddy.get("ERROR,WARN")).size() == 2);
+        REQUIRE(search(*teddy.get("HELLO,AX,B")).size() == 5);
+        REQUIRE(teddy.statistics().hits == 1);
+        REQUIRE_THROWS_AS(teddy.get(""), std::invalid_argument);
+        REQUIRE(teddy.size() == 2);
+        REQUIRE_THROWS_AS(trl::SearcherCache<trl::TeddySearcher>(0, 1, factory), std::invalid_argument);
+    }
+
+    SECTION("Least recently used eviction") {
+        trl::SearcherCache<trl::ShiftOrSearcher<std::string::const_iterator>> cache(2, 1);
+        auto hello = cache.get("HELLO");
+        cache.get("A");
+        cache.get("HELLO");
+        cache.get("AX"); // Evicts "A"
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.statistics().evictions == 1);
+
+        cache.get("HELLO");
+        REQUIRE(cache.statistics().hits == 2);
+        cache.get("A");
+        REQUIRE(cache.statistics().misses == 4);
+
+        // ===== An evicted searcher remains valid while it is referenced.
+        cache.get("ERROR");
+        cache.get("WARN");
+        REQUIRE(cache.statistics().evictions == 4);
+        REQUIRE(search(*hello).size() == 2);
+    }
+
+    SECTION("Capacity across shards") {
+        trl::SearcherCache<trl::ShiftOrSearcher<std::string::const_iterator>> cache(17);
+        for (std::size_t i = 0; i < 40; ++i) cache.get("needle" + std::to_string(i));
+        REQUIRE(cache.size() == 17);
+        REQUIRE(cache.statistics().evictions == 40 - 17);
+
+        trl::SearcherCache<trl::ShiftOrSearcher<std::string::const_iterator>> full(16);
+        for (std::size_t i = 0; i < 16; ++i) full.get("needle" + std::to_string(i));
+        REQUIRE(full.statistics().evictions == 0);
+        full.get("needle16");
+        REQUIRE(full.size() == 16);
+        REQUIRE(full.statistics().evictions == 1);
+
+        full.clear();
+        REQUIRE(full.size() == 0);
+    }
+
+    SECTION("Concurrent lookups") {
+        trl::SearcherCache<std::boyer_moore_horspool_searcher<std::string::const_iterator>> cache(16, 4);
+        std::vector<std::string> needles = {"HELLO", "A", "AX", "ERROR", "WARN", "404", "B", "BA"};
+        std::vector<std::size_t> counts(4, 0);
+
+        std::vector<std::thread> threads;
+        for (std::size_t thread = 0; thread < 4; ++thread)
+            threads.emplace_back([&, thread] {
+                for (int i = 0; i < 1000; ++i)
+                    counts[thread] += search(*cache.get(needles[static_cast<std::size_t>(i) % needles.size()])).size();
+            });
+        for (auto& thread : threads) thread.join();
+
+        const auto statistics = cache.statistics();
+        REQUIRE(statistics.hits + statistics.misses == 4000);
+        REQUIRE(statistics.misses >= needles.size());
+        REQUIRE(cache.size() == needles.size());
+        REQUIRE(counts[0] == counts[3]);
+    }
+}
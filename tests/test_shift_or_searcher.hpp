@@ -0,0 +1,92 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <forward_list>
+#include <initializer_list>
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::search_all using searchers, and trl::ShiftOrSearcher
+ *
+ * Description: Test the searcher overload of trl::search_all with both a standard library searcher and the
+ * trl::ShiftOrSearcher, comparing with the default trl::search_all. Patterns of various lengths (up to the maximum of
+ * 64 elements) are used, as well as patterns of character classes. The std::deque case exercises the generic
+ * (non-contiguous) code path, and the std::forward_list case the path for iterators which can not step backwards.
+ */
+TEMPLATE_TEST_CASE("Search for all occurrences using a searcher",
+                   "[search_all][ShiftOrSearcher]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>),
+                   (std::forward_list<char>)) {
+
+    std::string str;
+    for (std::size_t i = 0; i < 2000; ++i) str += "abcab"[(i * i + i / 7) % 5];
+    TestType container(str.begin(), str.end());
+
+    // ===== Compare the results of the searchers with the default search_all.
+    for (std::size_t length : std::initializer_list<std::size_t> {1, 2, 3, 5, 8, 16, 63, 64}) {
+        auto pattern = str.substr(1000, length);
+
+        std::vector<decltype(container.begin())> expected;
+        std::vector<decltype(container.begin())> results;
+        trl::search_all(container.begin(), container.end(), pattern.begin(), pattern.end(), std::back_inserter(expected));
+        REQUIRE(!expected.empty());
+
+        trl::search_all(container.begin(), container.end(), trl::ShiftOrSearcher(pattern.begin(), pattern.end()),
+                        std::back_inserter(results));
+        REQUIRE(results == expected);
+
+        results.clear();
+        trl::search_all(container.begin(), container.end(), std::default_searcher(pattern.begin(), pattern.end()),
+                        std::back_inserter(results));
+        REQUIRE(results == expected);
+    }
+
+    // ===== A pattern which does not occur, and an empty pattern, are never found.
+    std::string missing = "abcabcabc";
+    std::string empty;
+    std::vector<decltype(container.begin())> results;
+    trl::search_all(container.begin(), container.end(), trl::ShiftOrSearcher(missing.begin(), missing.end()),
+                    std::back_inserter(results));
+    trl::search_all(container.begin(), container.end(), trl::ShiftOrSearcher(empty.begin(), empty.end()),
+                    std::back_inserter(results));
+    REQUIRE(results.empty());
+}
+
+/*
+ * Test: trl::ShiftOrSearcher with character classes
+ *
+ * Description: Test patterns where each position is a trl::CharClass, and that patterns longer than 64 elements
+ * are rejected.
+ */
+TEST_CASE("Search using a ShiftOrSearcher with character classes", "[ShiftOrSearcher]") {
+
+    // ===== Search for a number of two digits, followed by "px".
+    std::string str = "width: 12px; height: 7px; margin: 345px; top: 99px";
+    std::vector<trl::CharClass> pattern = {trl::CharClass::digit(), trl::CharClass::digit(),
+                                           trl::CharClass::of("p"), trl::CharClass::of("x")};
+
+    std::vector<decltype(str.begin())> results;
+    trl::search_all(str.begin(), str.end(), trl::ShiftOrSearcher(pattern.begin(), pattern.end()),
+                    std::back_inserter(results));
+    REQUIRE(results.size() == 3);
+    REQUIRE(std::string(results[0], results[0] + 4) == "12px");
+    REQUIRE(std::string(results[1], results[1] + 4) == "45px");
+    REQUIRE(std::string(results[2], results[2] + 4) == "99px");
+
+    // ===== The searcher can also be used with std::search.
+    auto found = std::search(str.begin(), str.end(), trl::ShiftOrSearcher(pattern.begin(), pattern.end()));
+    REQUIRE(found == results[0]);
+
+    // ===== Patterns longer than 64 elements are rejected.
+    std::string longPattern(65, 'a');
+    REQUIRE_THROWS_AS(trl::ShiftOrSearcher(longPattern.begin(), longPattern.end()), std::length_error);
+}
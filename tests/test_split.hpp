@@ -326,3 +326,101 @@ TEMPLATE_TEST_CASE("Split a container using ByLength",
         REQUIRE(results[3] == TestType{'H', 'E', 'L'});
     }
 }
+
+/*
+ * A delimiter type without support for limiting the number of points found, for testing that split discards the
+ * excess points when max_splits is given.
+ */
+struct UnlimitedSemicolon
+{
+    template<typename Iter>
+    auto find(Iter begin, Iter end) {
+        std::vector<Iter> locations;
+        trl::find_all(begin, end, std::back_inserter(locations), ';');
+        return locations;
+    }
+
+    [[nodiscard]] int length() const { return 1; }
+};
+
+TEMPLATE_TEST_CASE("Split a container using max_splits",
+                   "[Split MaxSplits]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByElement: Max splits") {
+        TestType container = {'k', 'e', 'y', '=', 'v', 'a', 'l', '=', 'x', '=', 'y'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByElement('='), 1);
+
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == TestType{'k', 'e', 'y'});
+        REQUIRE(results[1] == TestType{'v', 'a', 'l', '=', 'x', '=', 'y'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split BySequence: Max splits") {
+        TestType container = {'A', '#', '#', 'B', '#', '#', 'C', '#', '#'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::BySequence(TestType{'#', '#'}), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'A'});
+        REQUIRE(results[1] == TestType{'B'});
+        REQUIRE(results[2] == TestType{'C', '#', '#'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByAnyElement: Max splits") {
+        TestType container = {'A', ':', 'B', ',', 'C', '.', 'D'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByAnyElement(TestType{':', ',', '.'}), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'A'});
+        REQUIRE(results[1] == TestType{'B'});
+        REQUIRE(results[2] == TestType{'C', '.', 'D'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByLength: Max splits") {
+        TestType container = {'H', 'E', 'L', 'L', 'O', 'W', 'O', 'R', 'L', 'D', 'X'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByLength(3), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'H', 'E', 'L'});
+        REQUIRE(results[1] == TestType{'L', 'O', 'W'});
+        REQUIRE(results[2] == TestType{'O', 'R', 'L', 'D', 'X'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByElement: More splits than delimiters") {
+        TestType container = {'A', ';', 'B'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByElement(';'), 5);
+
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == TestType{'A'});
+        REQUIRE(results[1] == TestType{'B'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split with a delimiter type without limited find") {
+        TestType container = {'A', ';', 'B', ';', 'C'};
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), UnlimitedSemicolon(), 1);
+
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == TestType{'A'});
+        REQUIRE(results[1] == TestType{'B', ';', 'C'});
+    }
+}
@@ -0,0 +1,62 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::split and trl::rsplit with trl::ByAnyOf
+ *
+ * Description: Compare trl::ByAnyOf with trl::ByAnyElement, for a small delimiter set (compared element by element)
+ * and a larger set (classified with table lookups), with and without a maximum number of splits. The text is long
+ * enough for the vectorized loops as well as the scalar tails to be exercised. The std::deque case exercises the
+ * generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Split a container using ByAnyOf",
+                   "[Split ByAnyOf]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str;
+    for (std::size_t i = 0; i < 1000; ++i) str += "field,;\tdata|\xff:x"[(i * i + i / 5) % 16];
+    TestType container(str.begin(), str.end());
+
+    auto check = [&](const std::string& delimiters, auto delimiter) {
+        for (std::size_t max_splits : {std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(-1)}) {
+            std::vector<TestType> expected;
+            std::vector<TestType> results;
+            trl::split(container, std::back_inserter(expected), trl::ByAnyElement(delimiters), max_splits);
+            trl::split(container, std::back_inserter(results), delimiter, max_splits);
+            REQUIRE(results == expected);
+
+            expected.clear();
+            results.clear();
+            trl::rsplit(container, std::back_inserter(expected), trl::ByAnyElement(delimiters), max_splits);
+            trl::rsplit(container, std::back_inserter(results), delimiter, max_splits);
+            REQUIRE(results == expected);
+        }
+    };
+
+    check(",", trl::ByAnyOf<','>());
+    check(",;\t", trl::ByAnyOf<',', ';', '\t'>());
+    check(",;\t|:\xff", trl::ByAnyOf<',', ';', '\t', '|', ':', '\xff'>());
+    check("#", trl::ByAnyOf<'#'>());
+}
+
+/*
+ * Test: trl::split with trl::ByAnyOf, with delimiters at the beginning and the end of the container.
+ */
+TEST_CASE("Split a short container using ByAnyOf", "[Split ByAnyOf]") {
+
+    std::string              str = ",a;b\tc,";
+    std::vector<std::string> results;
+    trl::split(str, std::back_inserter(results), trl::ByAnyOf<',', ';', '\t'>());
+    REQUIRE(results == std::vector<std::string>{"", "a", "b", "c", ""});
+
+    results.clear();
+    trl::rsplit(str, std::back_inserter(results), trl::ByAnyOf<',', ';', '\t'>(), 2);
+    REQUIRE(results == std::vector<std::string>{",a;b", "c", ""});
+}
@@ -0,0 +1,100 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::split using trl::ByLine
+ *
+ * Description: Test that "\n" and "\r\n" (and optionally "\r") are treated as a single line break, without leaving
+ * stray '\r' characters in the lines. The std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Split a container using ByLine",
+                   "[Split ByLine]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    auto toStrings = [](const std::vector<TestType>& lines) {
+        std::vector<std::string> result;
+        for (const auto& line : lines) result.emplace_back(line.begin(), line.end());
+        return result;
+    };
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByLine: Mixed line breaks") {
+        std::string str = "one\ntwo\r\nthree\rfour\r\n\nfive";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByLine());
+        REQUIRE(toStrings(results) == std::vector<std::string>{"one", "two", "three\rfour", "", "five"});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByLine: Lone carriage returns") {
+        std::string str = "one\ntwo\r\nthree\rfour\r\n\nfive\r";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByLine(true));
+        REQUIRE(toStrings(results) == std::vector<std::string>{"one", "two", "three", "four", "", "five", ""});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByLine: Trailing line break") {
+        std::string str = "a\r\nb\r\n";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByLine());
+        REQUIRE(toStrings(results) == std::vector<std::string>{"a", "b", ""});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByLine: Max splits and rsplit") {
+        std::string str = "a\r\nb\nc\r\nd";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByLine(), 1);
+        REQUIRE(toStrings(results) == std::vector<std::string>{"a", "b\nc\r\nd"});
+
+        results.clear();
+        trl::rsplit(container, std::back_inserter(results), trl::ByLine(), 2);
+        REQUIRE(toStrings(results) == std::vector<std::string>{"a\r\nb", "c", "d"});
+    }
+}
+
+/*
+ * Test: trl::ByLine (long input)
+ *
+ * Description: Test line breaks at every position relative to the 64 byte blocks, including "\r\n" pairs that
+ * straddle two blocks, by comparing with the lines used to build the input.
+ */
+TEST_CASE("Split a long text using ByLine", "[Split ByLine]") {
+
+    for (bool splitOnCR : {false, true}) {
+        std::vector<std::string> expected;
+        std::string text;
+        for (int i = 0; i < 200; ++i) {
+            expected.emplace_back(static_cast<std::size_t>(i % 67), 'x');
+            text += expected.back();
+            text += (i % 3 == 0) ? "\r\n" : ((i % 3 == 1 || !splitOnCR) ? "\n" : "\r");
+        }
+        expected.emplace_back();
+
+        std::vector<std::string> results;
+        trl::split(text, std::back_inserter(results), trl::ByLine(splitOnCR));
+        REQUIRE(results == expected);
+
+        std::vector<std::string> reversed;
+        trl::rsplit(text, std::back_inserter(reversed), trl::ByLine(splitOnCR));
+        REQUIRE(reversed == expected);
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <type_traits>
+#include <cctype>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::CharClass
+ *
+ * Description: Test that the predefined character classes agree with the C library classification functions for all
+ * byte values, and that trl::find_all_if / trl::find_all_if_not give the same results with a CharClass predicate as
+ * with an equivalent lambda. The inputs are long enough to exercise the vectorized kernel, as well as the tail loop.
+ */
+TEST_CASE("Classify characters using CharClass", "[CharClass]") {
+
+    static_assert(trl::CharClass::digit()('7'), "CharClass should be usable in constant expressions");
+    static_assert(!trl::CharClass::digit()('x'), "CharClass should be usable in constant expressions");
+
+    // ===== Compare the predefined classes with the C library (in the "C" locale).
+    for (int c = 0; c < 256; ++c) {
+        auto value = static_cast<unsigned char>(c);
+        REQUIRE(trl::CharClass::space()(value) == (std::isspace(c) != 0));
+        REQUIRE(trl::CharClass::digit()(value) == (std::isdigit(c) != 0));
+        REQUIRE(trl::CharClass::alpha()(value) == (std::isalpha(c) != 0));
+        REQUIRE(trl::CharClass::alnum()(value) == (std::isalnum(c) != 0));
+        REQUIRE(trl::CharClass::punct()(value) == (std::ispunct(c) != 0));
+        REQUIRE((~trl::CharClass::alnum())(value) == (std::isalnum(c) == 0));
+    }
+
+    // ===== Elements wider than a byte are classified by value.
+    REQUIRE(trl::CharClass::space()(L' '));
+    REQUIRE_FALSE(trl::CharClass::space()(static_cast<wchar_t>(0x120)));
+    REQUIRE_FALSE(trl::CharClass::range(0, 255)(-1));
+
+    // ===== Build a string with all byte values (including those above 0x7f) in a scrambled order.
+    std::string str;
+    for (int i = 0; i < 1000; ++i) str += static_cast<char>((i * 37 + i / 256) % 256);
+
+    for (auto charClass : {trl::CharClass::space(),
+                           trl::CharClass::alnum(),
+                           trl::CharClass::punct(),
+                           trl::CharClass::of("\x80\xff,") | trl::CharClass::digit()}) {
+        auto lambda = [&](char c) { return charClass.contains(static_cast<unsigned char>(c)); };
+
+        std::vector<decltype(str.begin())> expected;
+        std::vector<decltype(str.begin())> results;
+        trl::find_all_if(str.begin(), str.end(), std::back_inserter(expected), lambda);
+        trl::find_all_if(str.begin(), str.end(), std::back_inserter(results), charClass);
+        REQUIRE(results == expected);
+
+        expected.clear();
+        results.clear();
+        trl::find_all_if_not(str.begin(), str.end(), std::back_inserter(expected), lambda);
+        trl::find_all_if_not(str.begin(), str.end(), std::back_inserter(results), charClass);
+        REQUIRE(results == expected);
+    }
+}
+
+/*
+ * Test: trl::split using trl::ByPredicate
+ *
+ * Description: Test splitting on all elements satisfying a predicate, using both a lambda and a CharClass. The
+ * std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Split a container using ByPredicate",
+                   "[Split ByPredicate]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    std::string str = "the quick\tbrown  fox\njumps";
+    TestType container(str.begin(), str.end());
+
+    auto toStrings = [](const std::vector<TestType>& pieces) {
+        std::vector<std::string> result;
+        for (const auto& piece : pieces) result.emplace_back(piece.begin(), piece.end());
+        return result;
+    };
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByPredicate: CharClass") {
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByPredicate(trl::CharClass::space()));
+        REQUIRE(toStrings(results) == std::vector<std::string>{"the", "quick", "brown", "", "fox", "jumps"});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByPredicate: Lambda") {
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByPredicate([](char c) { return c == 'o'; }));
+        REQUIRE(toStrings(results) == std::vector<std::string>{"the quick\tbr", "wn  f", "x\njumps"});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByPredicate: Max splits and rsplit") {
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByPredicate(trl::CharClass::space()), 2);
+        REQUIRE(toStrings(results) == std::vector<std::string>{"the", "quick", "brown  fox\njumps"});
+
+        results.clear();
+        trl::rsplit(container, std::back_inserter(results), trl::ByPredicate(trl::CharClass::space()), 2);
+        REQUIRE(toStrings(results) == std::vector<std::string>{"the quick\tbrown ", "fox", "jumps"});
+    }
+}
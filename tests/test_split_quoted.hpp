@@ -0,0 +1,105 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::split using trl::ByQuotedDelimiter
+ *
+ * Description: Test that delimiters inside quoted fields are not split on, that escaped quotes are handled, and that
+ * the quotes are kept in the fields. The std::deque case exercises the generic (non-contiguous) code path.
+ */
+TEMPLATE_TEST_CASE("Split a container using ByQuotedDelimiter",
+                   "[Split ByQuotedDelimiter]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByQuotedDelimiter: Case 1") {
+        std::string str = R"(a,"b,c",d)";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByQuotedDelimiter(','));
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'a'});
+        REQUIRE(results[1] == TestType{'"', 'b', ',', 'c', '"'});
+        REQUIRE(results[2] == TestType{'d'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByQuotedDelimiter: Escaped quotes") {
+        std::string str = R"("say ""hi, there""",,"x")";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByQuotedDelimiter(','));
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType(str.begin(), str.begin() + 19));
+        REQUIRE(results[1].empty());
+        REQUIRE(results[2] == TestType{'"', 'x', '"'});
+    }
+
+    // ===== Run tests for the current case definition
+    SECTION("Split ByQuotedDelimiter: Max splits") {
+        std::string str = R"(a;"b;c";d;e)";
+        TestType container(str.begin(), str.end());
+
+        std::vector<TestType> results;
+        trl::split(container, std::back_inserter(results), trl::ByQuotedDelimiter(';'), 2);
+
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == TestType{'a'});
+        REQUIRE(results[1] == TestType{'"', 'b', ';', 'c', '"'});
+        REQUIRE(results[2] == TestType{'d', ';', 'e'});
+    }
+}
+
+/*
+ * Test: trl::ByQuotedDelimiter (long records)
+ *
+ * Description: Test that the quote state is carried correctly across the 64 byte blocks, by comparing with a simple
+ * reference implementation on a long record with quoted fields of varying lengths.
+ */
+TEST_CASE("Split a long record using ByQuotedDelimiter", "[Split ByQuotedDelimiter]") {
+
+    // ===== Build a record with quoted fields (containing delimiters and escaped quotes) of increasing length.
+    std::string record;
+    for (int i = 0; i < 50; ++i) {
+        record += "\"";
+        for (int j = 0; j < i * 3; ++j) record += (j % 7 == 0) ? "," : (j % 11 == 0 ? "\"\"" : "x");
+        record += "\",plain" + std::to_string(i) + ",";
+    }
+
+    // ===== Reference: the fields, as found by a character-by-character state machine.
+    std::vector<std::string> expected;
+    std::string field;
+    bool inside = false;
+    for (auto c : record) {
+        if (c == '"') inside = !inside;
+        if (c == ',' && !inside) {
+            expected.push_back(field);
+            field.clear();
+        }
+        else
+            field += c;
+    }
+    expected.push_back(field);
+
+    std::vector<std::string> results;
+    trl::split(record, std::back_inserter(results), trl::ByQuotedDelimiter(','));
+    REQUIRE(results == expected);
+
+    std::vector<std::string> reversed;
+    trl::rsplit(record, std::back_inserter(reversed), trl::ByQuotedDelimiter(','), 3);
+    REQUIRE(reversed.size() == 4);
+    REQUIRE(reversed[3] == expected.back());
+}
@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::SuffixArrayIndex
+ *
+ * Description: Test that the suffix array and LCP array are correct for strings with many repeats (which exercise
+ * the recursion of SA-IS), and that searching the index gives the same results as trl::search_all, including
+ * for self-overlapping needles, needles at the start and end of the range, needles longer than any suffix, and empty
+ * needles and ranges. The index is tested on both std::string and std::vector<unsigned char>.
+ */
+TEMPLATE_TEST_CASE("Search for all occurrences of a sequence using a SuffixArrayIndex",
+                   "[suffix_array_index]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::vector<unsigned char>)) {
+
+    for (const auto& corpus : create_index_corpora()) {
+        TestType container(corpus.begin(), corpus.end());
+        trl::SuffixArrayIndex index(container.begin(), container.end());
+
+        // ===== The suffix array lists the suffixes in sorted order, and the LCP array their common prefixes.
+        const auto& sa  = index.suffix_array();
+        const auto& lcp = index.lcp_array();
+        REQUIRE(sa.size() == corpus.size());
+        REQUIRE(index.size() == corpus.size());
+        for (std::size_t i = 1; i < sa.size(); ++i) {
+            auto previous = std::string_view(corpus).substr(sa[i - 1]);
+            auto current  = std::string_view(corpus).substr(sa[i]);
+            std::size_t common = 0;
+            while (common < previous.size() && common < current.size() && previous[common] == current[common]) ++common;
+            REQUIRE(std::lexicographical_compare(previous.begin(), previous.end(), current.begin(), current.end(),
+                                                 [](char a, char b) { return static_cast<unsigned char>(a) < static_cast<unsigned char>(b); }));
+            REQUIRE(lcp[i] == common);
+        }
+
+        // ===== Searching the index gives the same results as search_all.
+        check_index_searches(index, container, create_index_needles(corpus));
+    }
+}
+
+TEST_CASE("SuffixArrayIndex of an empty range, and of a range too long for the IndexType", "[suffix_array_index]") {
+
+    std::string corpus;
+    trl::SuffixArrayIndex index(corpus.begin(), corpus.end());
+    std::string needle = "a";
+    std::vector<std::string::iterator> results;
+    index.search_all(needle.begin(), needle.end(), std::back_inserter(results));
+    REQUIRE(results.empty());
+    REQUIRE(index.count(needle.begin(), needle.end()) == 0);
+
+    std::string large(300, 'a');
+    REQUIRE_THROWS_AS((trl::SuffixArrayIndex<std::string::iterator, std::uint8_t>(large.begin(), large.end())),
+                      std::length_error);
+    REQUIRE((trl::SuffixArrayIndex<std::string::iterator, std::uint16_t>(large.begin(), large.end())).count(needle.begin(), needle.end()) == 300);
+}
@@ -0,0 +1,179 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <random>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::TrigramIndex
+ *
+ * Description: Test that searching a collection of documents through the trigram index gives the same results as
+ * calling trl::search_all on every document, for needles shorter than a trigram (which can not be filtered), needles
+ * which are not found, and needles whose trigrams all occur in documents not containing the needle. The documents
+ * are added in several parts, with one and several threads, and the candidates must be the same in all cases.
+ */
+TEMPLATE_TEST_CASE("Search for all occurrences of a sequence in a collection using a TrigramIndex",
+                   "[trigram_index]",
+                   (std::string),
+                   (std::vector<char>)) {
+
+    std::mt19937 random(5);
+    const char*  words[] = {"GET", "POST", "/index", ".html", "/form", "user", "id=", "42", "\xff\x80", "ab", "ba"};
+    std::vector<TestType> documents;
+    for (int i = 0; i < 500; ++i) {
+        std::string document;
+        for (auto count = random() % 12; count > 0; --count) document += words[random() % 11];
+        documents.emplace_back(document.begin(), document.end());
+    }
+
+    using Iterator = decltype(std::begin(std::declval<const TestType&>()));
+
+    trl::TrigramIndex<TestType> sequential;
+    REQUIRE(sequential.add(documents.begin(), documents.end(), 1) == 0);
+
+    trl::TrigramIndex<TestType> parallel;
+    REQUIRE(parallel.add(documents.begin(), documents.begin() + 100, 4) == 0);
+    REQUIRE(parallel.add(documents.begin() + 100, documents.begin() + 101, 4) == 100);
+    REQUIRE(parallel.add(documents[101]) == 101);
+    REQUIRE(parallel.add(documents.begin() + 102, documents.end(), 3) == 102);
+    REQUIRE(parallel.size() == documents.size());
+    REQUIRE(&parallel.document(7) == &documents[7]);
+
+    for (std::string needle : {"GET", "POST/form", "/index.html", "42user", "abab", "baba", "aba", "ab", "a",
+                               "\xff\x80" "ab", "user42id=", "GETGET", "zzz", "GEP", ""}) {
+        std::vector<trl::DocumentMatch<Iterator>> expected;
+        for (std::size_t document = 0; document < documents.size(); ++document) {
+            std::vector<Iterator> positions;
+            trl::search_all(std::begin(std::as_const(documents[document])), std::end(std::as_const(documents[document])),
+                            needle.begin(), needle.end(), std::back_inserter(positions));
+            for (auto position : positions) expected.push_back({document, position});
+        }
+
+        for (const auto* index : {&sequential, &parallel}) {
+            std::vector<trl::DocumentMatch<Iterator>> actual;
+            index->search_all(needle.begin(), needle.end(), std::back_inserter(actual));
+            INFO(needle);
+            REQUIRE(actual.size() == expected.size());
+            for (std::size_t i = 0; i < actual.size(); ++i) {
+                REQUIRE(actual[i].document == expected[i].document);
+                REQUIRE(actual[i].position == expected[i].position);
+            }
+        }
+
+        // ===== The candidates include all documents with a match, and are filtered for needles of three or more.
+        std::vector<std::size_t> candidates, other;
+        sequential.candidates(needle.begin(), needle.end(), std::back_inserter(candidates));
+        parallel.candidates(needle.begin(), needle.end(), std::back_inserter(other));
+        REQUIRE(candidates == other);
+        REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+        for (const auto& match : expected)
+            REQUIRE(std::binary_search(candidates.begin(), candidates.end(), match.document));
+        if (needle.size() >= 3)
+            REQUIRE(candidates.size() < documents.size());
+        if (!needle.empty() && needle.size() < 3)
+            REQUIRE(candidates.size() == documents.size());
+    }
+}
+
+namespace
+{
+    /**
+     * @brief A document which throws when it is read, if it is marked as failing.
+     */
+    struct FailingDocument
+    {
+        std::string text;
+        bool        fail;
+
+        const char* begin() const {
+            if (fail)
+                throw std::runtime_error("Failing document");
+            return text.data();
+        }
+
+        const char* end() const {
+            return text.data() + text.size();
+        }
+    };
+
+    /**
+     * @brief A forward iterator over documents, which throws when the document at a given index is dereferenced.
+     */
+    struct FailingIterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::string*;
+        using reference         = const std::string&;
+
+        const std::string* document;
+        const std::string* failing;
+
+        reference operator*() const {
+            if (document == failing)
+                throw std::runtime_error("Failing iterator");
+            return *document;
+        }
+
+        FailingIterator& operator++() {
+            ++document;
+            return *this;
+        }
+
+        bool operator==(const FailingIterator& other) const {
+            return document == other.document;
+        }
+
+        bool operator!=(const FailingIterator& other) const {
+            return document != other.document;
+        }
+    };
+}  // namespace
+
+/*
+ * Test: trl::TrigramIndex when adding documents fails
+ *
+ * Description: Test that if an exception is thrown while a batch of documents is added (by the iterator over the
+ * documents, or while their trigrams are extracted), the batch is removed again, so that no document is left in the
+ * index without its postings.
+ */
+TEST_CASE("TrigramIndex is unchanged when adding documents fails", "[trigram_index]") {
+
+    std::vector<FailingDocument> documents = {{"GET /index.html", false}, {"POST /form", false},
+                                              {"GET /form", false},       {"PUT /form", true},
+                                              {"GET /other", false}};
+
+    for (std::size_t threads : std::initializer_list<std::size_t> {1, 2}) {
+        trl::TrigramIndex<FailingDocument> index;
+        REQUIRE(index.add(documents.begin(), documents.begin() + 2, threads) == 0);
+        REQUIRE_THROWS_AS(index.add(documents.begin() + 2, documents.end(), threads), std::runtime_error);
+        REQUIRE(index.size() == 2);
+
+        std::string              needle = "/form";
+        std::vector<std::size_t> candidates;
+        index.candidates(needle.begin(), needle.end(), std::back_inserter(candidates));
+        REQUIRE(candidates == std::vector<std::size_t> {1});
+
+        REQUIRE(index.add(documents.begin() + 4, documents.end(), threads) == 2);
+        needle = "GET";
+        candidates.clear();
+        index.candidates(needle.begin(), needle.end(), std::back_inserter(candidates));
+        REQUIRE(candidates == std::vector<std::size_t> {0, 2});
+    }
+
+    // ===== The iterator over the documents throws, after some of them have been added.
+    std::vector<std::string>       texts = {"GET /index.html", "POST /form", "GET /form"};
+    trl::TrigramIndex<std::string> index;
+    REQUIRE_THROWS_AS(index.add(FailingIterator {texts.data(), texts.data() + 2},
+                                FailingIterator {texts.data() + 3, texts.data() + 2}),
+                      std::runtime_error);
+    REQUIRE(index.size() == 0);
+    REQUIRE(index.add(texts.begin(), texts.end()) == 0);
+    REQUIRE(index.size() == 3);
+}
@@ -0,0 +1,123 @@
+#include <catch.hpp>
+#include <troldalgo.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "test_case_helpers.hpp"
+
+/*
+ * Test: trl::find_invalid_utf8 and trl::is_valid_utf8
+ *
+ * Description: Test UTF-8 validation of well-formed text, and of the classes of ill-formed sequences (stray
+ * continuation bytes, overlong encodings, surrogates, code points above U+10FFFF and truncated sequences), placed
+ * after a run of ASCII long enough to exercise the ASCII fast path.
+ */
+TEMPLATE_TEST_CASE("Validate UTF-8 using find_invalid_utf8",
+                   "[find_invalid_utf8]",
+                   (std::string),
+                   (std::vector<unsigned char>),
+                   (std::deque<char>)) {
+
+    const std::string ascii(37, 'a');
+    const std::string valid = "a\xC3\xA6\xE2\x82\xAC\xF0\x9F\x98\x80\xED\x9F\xBF\xF4\x8F\xBF\xBFz";
+
+    // ===== Valid text, with and without leading ASCII.
+    for (const auto& str : {std::string(), ascii, valid, ascii + valid + ascii}) {
+        TestType container(str.begin(), str.end());
+        REQUIRE(trl::is_valid_utf8(container.begin(), container.end()));
+    }
+
+    // ===== Invalid sequences; the position of the first invalid byte after the ASCII prefix is checked.
+    for (const auto& invalid : {std::string("\x80"),           // Stray continuation byte
+                                std::string("\xC0\xAF"),       // Overlong encoding of '/'
+                                std::string("\xC1\xBF"),       // Overlong two-byte encoding
+                                std::string("\xE0\x9F\xBF"),   // Overlong three-byte encoding
+                                std::string("\xF0\x8F\xBF\xBF"), // Overlong four-byte encoding
+                                std::string("\xED\xA0\x80"),   // Surrogate U+D800
+                                std::string("\xF4\x90\x80\x80"), // Above U+10FFFF
+                                std::string("\xF5\x80\x80\x80"), // Invalid lead byte
+                                std::string("\xE2\x82"),       // Truncated sequence
+                                std::string("\xE2\x28\xAC")}) {  // Missing continuation byte
+        auto str = ascii + valid + invalid + ascii;
+        TestType container(str.begin(), str.end());
+
+        auto result = trl::find_invalid_utf8(container.begin(), container.end());
+        REQUIRE(std::distance(container.begin(), result) == static_cast<std::ptrdiff_t>(ascii.size() + valid.size()));
+        REQUIRE_FALSE(trl::is_valid_utf8(container.begin(), container.end()));
+    }
+}
+
+/*
+ * Test: trl::split using trl::ByUtf8Length
+ *
+ * Description: Test that UTF-8 text is split into chunks of at most the given size, without splitting any
+ * multi-byte character, both forwards (split) and backwards (rsplit). Malformed text, with long runs of continuation
+ * bytes, must still be split into chunks of bounded size, and a non-positive maximum size is rejected.
+ */
+TEMPLATE_TEST_CASE("Split UTF-8 text using ByUtf8Length",
+                   "[Split ByUtf8Length]",
+                   (std::string),
+                   (std::vector<char>),
+                   (std::deque<char>)) {
+
+    // ===== Mix characters of one to four bytes.
+    std::string str;
+    for (int i = 0; i < 100; ++i) str += (i % 4 == 0) ? "a" : (i % 4 == 1) ? "\xC3\xA6" : (i % 4 == 2) ? "\xE2\x82\xAC" : "\xF0\x9F\x98\x80";
+    TestType container(str.begin(), str.end());
+
+    for (std::ptrdiff_t maxBytes : {1, 2, 3, 4, 5, 7, 64}) {
+        for (bool reverse : {false, true}) {
+            std::vector<TestType> results;
+            if (reverse)
+                trl::rsplit(container, std::back_inserter(results), trl::ByUtf8Length(maxBytes));
+            else
+                trl::split(container, std::back_inserter(results), trl::ByUtf8Length(maxBytes));
+
+            std::string joined;
+            for (const auto& chunk : results) {
+                REQUIRE(!chunk.empty());
+                REQUIRE(trl::is_valid_utf8(chunk.begin(), chunk.end()));
+                if (maxBytes >= 4)
+                    REQUIRE(static_cast<std::ptrdiff_t>(chunk.size()) <= maxBytes);
+                joined.append(chunk.begin(), chunk.end());
+            }
+            REQUIRE(joined == str);
+        }
+    }
+
+    // ===== Max splits
+    std::vector<TestType> results;
+    trl::split(container, std::back_inserter(results), trl::ByUtf8Length(4), 2);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0] == TestType{'a', '\xC3', '\xA6'});
+    REQUIRE(results[1] == TestType{'\xE2', '\x82', '\xAC'});
+
+    // ===== Malformed text: a single character followed by a long run of continuation bytes.
+    std::string malformed = "a" + std::string(1000, '\x80');
+    TestType    malformedContainer(malformed.begin(), malformed.end());
+    for (std::ptrdiff_t maxBytes : {1, 2, 16}) {
+        for (bool reverse : {false, true}) {
+            results.clear();
+            if (reverse)
+                trl::rsplit(malformedContainer, std::back_inserter(results), trl::ByUtf8Length(maxBytes));
+            else
+                trl::split(malformedContainer, std::back_inserter(results), trl::ByUtf8Length(maxBytes));
+
+            std::size_t total = 0;
+            for (const auto& chunk : results) {
+                REQUIRE(!chunk.empty());
+                REQUIRE(static_cast<std::ptrdiff_t>(chunk.size()) <= std::max<std::ptrdiff_t>(maxBytes, 4));
+                total += chunk.size();
+            }
+            REQUIRE(total == malformed.size());
+        }
+    }
+
+    REQUIRE_THROWS_AS(trl::ByUtf8Length(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(trl::ByUtf8Length(-1), std::invalid_argument);
+}